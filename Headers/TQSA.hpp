@@ -32,6 +32,7 @@
 #include <SDL_mixer.h>
 #endif
 #include <JCR6_Core.hpp>
+#include <atomic>
 
 namespace Slyvina {
 	namespace TQSA {
@@ -41,7 +42,15 @@ namespace Slyvina {
 
 		class _____TAudio {
 		private:
-			Mix_Chunk* ActualChunk = nullptr;
+			std::atomic<Mix_Chunk*> ActualChunk{ nullptr }; // Atomic, as the async loader fills it from another thread
+			std::atomic<bool> _Loading{ false };
+			int
+				_DeferChannel{ -2 }, // -2 means no play was deferred
+				_DeferLoops{ 0 };
+			std::string _LoadError{ "" };
+			int NotReady(int channel, int loops);
+			friend class __AudioLoader;
+			_____TAudio() {} // Empty. Only meant for the async loader.
 			/// <summary>
 			/// Disposes the sound chunk attacked from the memory (would happen automatically if the destructor is called)
 			/// </summary>
@@ -54,8 +63,31 @@ namespace Slyvina {
 			_____TAudio(JCR6::JT_Dir JCRResource, std::string JCREntry);
 			//_____TAudio(std::string JCRMain, std::string JCREntry);
 
+			/// <summary>
+			/// True when the sound is loaded. For sounds loaded asynchronously this becomes true once the loading is done.
+			/// </summary>
 			bool Valid();
 
+			/// <summary>
+			/// True while the sound is still waiting to be (or being) loaded asynchronously
+			/// </summary>
+			inline bool Loading() { return _Loading; }
+
+			/// <summary>
+			/// Why asynchronous loading failed (empty if it didn't)
+			/// </summary>
+			std::string LoadError();
+
+			/// <summary>
+			/// Memory taken by the decoded sound (0 when not loaded)
+			/// </summary>
+			size_t Bytes();
+
+			/// <summary>
+			/// True when this sound is playing on any channel
+			/// </summary>
+			bool Playing();
+
 			int Play(int loops = 0);
 			void ChPlay(int channel, int loops = 0);
 
@@ -64,6 +96,38 @@ namespace Slyvina {
 			~_____TAudio();
 		};
 
+		class _____TMusic;
+		typedef std::shared_ptr<_____TMusic> TMusic; // Shared pointer holding streamed music
+		typedef std::unique_ptr<_____TMusic> TUMusic; // Unique pointer holding streamed music
+
+		/// <summary>
+		/// Music is not decoded in one go like TAudio, but bit by bit while it plays, so a long track only costs a small buffer. Only one music can play at the time.
+		/// </summary>
+		class _____TMusic {
+		private:
+			Mix_Music* ActualMusic = nullptr;
+			std::shared_ptr<void> Source{ nullptr }; // The JCR6 data SDL_mixer reads from while playing (packed entries only), so it must live as long as the music does
+		public:
+			_____TMusic(const char* File);
+			/// <summary>
+			/// A stored JCR6 entry is streamed straight from its resource file. A packed one (or one in a block) can only be unpacked as a whole, so that one is kept in memory (still in its music format, not as PCM).
+			/// </summary>
+			_____TMusic(JCR6::JT_Dir JCRResource, std::string JCREntry);
+
+			bool Valid();
+
+			/// <summary>
+			/// Plays the music. Looping is done by the decoder, so there's no gap between the end and the start.
+			/// </summary>
+			/// <param name="loops">-1 means forever</param>
+			/// <param name="FadeInMS">Milliseconds to fade in</param>
+			bool Play(int loops = -1, int FadeInMS = 0);
+
+			Mix_Music* GetMusic() { return ActualMusic; }
+
+			~_____TMusic();
+		};
+
 		bool Init_TQSA(int demandflags=0);
 
 		std::string AudioError();
@@ -75,6 +139,103 @@ namespace Slyvina {
 		TAudio LoadAudio(std::string JCRResource, std::string Entry);
 		TUAudio LoadUAudio(std::string JCRResource, std::string Entry);
 
+		/// <summary>
+		/// What Play() does with a sound which is still being loaded asynchronously
+		/// </summary>
+		enum class AudioNotReady {
+			Skip, // Nothing (default)
+			Defer // Play it as soon as it's loaded
+		};
+		void AudioNotReadyPolicy(AudioNotReady Policy);
+
+		/// <summary>
+		/// Returns an empty sound right away, and has it loaded, decoded and converted to the mixer format on a worker thread (one per core). Valid() tells when it's ready.
+		/// The mixer is initiated here when that didn't happen yet.
+		/// JCR6 entries are read right away on the calling thread, so only the decoding is done on the workers. When the entry can't be read, nullptr is returned.
+		/// </summary>
+		TAudio LoadAudioAsync(std::string File);
+		TAudio LoadAudioAsync(JCR6::JT_Dir JCRResource, std::string Entry);
+
+		/// <summary>
+		/// Loads a whole bunch of sounds asynchronously, keeping all cores busy
+		/// </summary>
+		/// <returns>The sounds in the same order as the entries (nullptr for the ones that could not be read)</returns>
+		std::vector<TAudio> LoadAudioAsync(JCR6::JT_Dir JCRResource, const std::vector<std::string>& Entries);
+
+		/// <summary>
+		/// Number of sounds still waiting to be loaded asynchronously
+		/// </summary>
+		size_t AudioLoading();
+
+		/// <summary>
+		/// Waits until all asynchronous loading is done
+		/// </summary>
+		void AudioWait();
+
+		/// <summary>
+		/// LoadAudio() and LoadAudioAsync() keep the sounds they load in a cache, so loading the same file or JCR6 entry again gives the same TAudio. Case doesn't matter for JCR6 entry names.
+		/// JCR6 entries are cached per JT_Dir. Loading by resource file name uses the JT_Dir AudioResource() gives, so use that one for your own loads to share the cache with those.
+		/// (LoadUAudio() can't share, so it never uses the cache). Enabled by default.
+		/// </summary>
+		void AudioCache(bool Enabled);
+		bool AudioCache();
+
+		/// <summary>
+		/// Maximum memory in bytes the decoded sounds in the cache may take (default 64MB, 0 is unlimited).
+		/// When it's exceeded, the least recently loaded sounds nobody else holds and which aren't playing are thrown out.
+		/// Sounds still in use are never thrown out, so the cache can go over budget if all of them are.
+		/// </summary>
+		void AudioCacheBudget(size_t Bytes);
+		size_t AudioCacheBudget();
+
+		/// <summary>
+		/// Memory taken by the decoded sounds in the cache / the number of sounds in it
+		/// </summary>
+		size_t AudioCacheBytes();
+		size_t AudioCacheCount();
+
+		/// <summary>
+		/// Throws out idle sounds until the cache is within budget. Happens automatically on every load. Asynchronously loaded sounds only count once they are done, and then the cache is trimmed on the next load or AudioWait().
+		/// </summary>
+		void AudioCacheTrim();
+
+		/// <summary>
+		/// Empties the cache. Sounds still held elsewhere remain valid, but won't be shared with new loads anymore.
+		/// </summary>
+		void ClearAudioCache();
+
+		/// <summary>
+		/// The JCR6 resource LoadAudio(std::string JCRResource, std::string Entry) uses for this file. It's opened once and kept until the cache is cleared or disabled.
+		/// </summary>
+		/// <returns>nullptr when the resource could not be read (see AudioError())</returns>
+		JCR6::JT_Dir AudioResource(std::string File);
+
+		TMusic LoadMusic(std::string File);
+		TUMusic LoadUMusic(std::string File);
+		TMusic LoadMusic(JCR6::JT_Dir JCRResource, std::string Entry);
+		TUMusic LoadUMusic(JCR6::JT_Dir JCRResource, std::string Entry);
+		TMusic LoadMusic(std::string JCRResource, std::string Entry);
+		TUMusic LoadUMusic(std::string JCRResource, std::string Entry);
+
+		/// <summary>
+		/// Plays music, and keeps it in memory until other music is played this way
+		/// </summary>
+		bool PlayMusic(TMusic Music, int loops = -1, int FadeInMS = 0);
+
+		/// <summary>
+		/// Fades out the music playing now and fades in the new music, in ms milliseconds altogether. SDL_mixer only plays one music at the time, so the new one comes in right after the old one is gone. This function doesn't wait for that, and playing or stopping music before then cancels the fade in.
+		/// TQSA uses Mix_HookMusicFinished() for this, so don't set that hook yourself.
+		/// </summary>
+		bool CrossFade(TMusic Music, int ms = 2000, int loops = -1);
+
+		void StopMusic(int FadeOutMS = 0);
+		bool MusicPlaying();
+
+		/// <summary>
+		/// Volume of the music (0-128)
+		/// </summary>
+		void MusicVolume(int volume);
+
 	}
 
 }
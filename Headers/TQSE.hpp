@@ -40,6 +40,11 @@ namespace Slyvina {
 
 		typedef void (*EventFunction) (SDL_Event* Event);
 
+		/// <summary>
+		/// Returns false for events which should be thrown away before they ever reach the queue
+		/// </summary>
+		typedef bool (*EventFilterFunction) (SDL_Event* Event);
+
 
 		/// <summary>
 		/// Polls the event and gets all data. Please note, all other readout functions will only return the data based on what this function produces
@@ -47,12 +52,41 @@ namespace Slyvina {
 		/// <param name="EventCallBack"></param>
 		void Poll(EventFunction EventCallBack = nullptr);
 
+		/// <summary>
+		/// Makes Poll() call CallBack for every event of the given type (after the EventCallBack given to Poll() itself). Only one callback per type; nullptr removes it.
+		/// </summary>
+		void OnEvent(Uint32 Type, EventFunction CallBack);
+
+		/// <summary>
+		/// Makes SDL drop events of this type right away, so they never end up in the queue. (Don't ignore what TQSE needs itself, like keys and mouse buttons, unless you don't need these either)
+		/// </summary>
+		void EventIgnore(Uint32 Type, bool Ignore = true);
+		bool EventIgnored(Uint32 Type);
+
+		/// <summary>
+		/// Sets a filter SDL calls for every event before putting it in the queue. Please note, SDL can call it from other threads. nullptr removes the filter.
+		/// </summary>
+		void EventFilter(EventFilterFunction Filter);
+
+		/// <summary>
+		/// When on (default), Poll() turns a row of mouse motion events into one with the final position and the summed relative motion, so callbacks get one in stead of hundreds.
+		/// </summary>
+		void CoalesceMotion(bool on);
+		bool CoalesceMotion();
+
 		/// <summary>
 		/// Returns true if the last Poll had an App Termination request.
 		/// </summary>
 		/// <returns></returns>
 		bool AppTerminate();
 
+		/// <summary>
+		/// State of the window, as far as the window events Poll() got so far tell.
+		/// </summary>
+		bool WindowMinimized();
+		bool WindowHidden();
+		bool WindowFocused();
+
 
 		/// <summary>
 		/// Returns true if a key was hit during the last Poll
@@ -86,6 +120,128 @@ namespace Slyvina {
 		bool MouseReleased(int c);
 		int MouseWheelY();
 
+		/// <summary>
+		/// Writes every event Poll() takes to a file, together with the number of the Poll() it came in (counted from the start of the recording). Events carrying pointers (dropped files, user events) are left out.
+		/// </summary>
+		/// <returns>True if the file could be created</returns>
+		bool StartInputRecording(std::string File);
+		void StopInputRecording();
+		bool InputRecording();
+
+		/// <summary>
+		/// Makes Poll() take its events from a recording in stead of from SDL. Every Poll() gets exactly the events the same Poll() got when recording, so as long as the program calls Poll() once per frame, a session plays out the same way every time.
+		/// Real input is thrown away while replaying, except a request to quit.
+		/// </summary>
+		/// <param name="TerminateAtEnd">When the recording runs out AppTerminate() returns true (handy for benchmarks). Either way real input takes over from then on.</param>
+		/// <returns>True if the file could be read and is an input log</returns>
+		bool StartInputReplay(std::string File, bool TerminateAtEnd = true);
+		void StopInputReplay();
+		bool InputReplaying();
+
+		/// <summary>
+		/// Number of times Poll() was called since the last recording or replay started
+		/// </summary>
+		uint64 InputFrame();
+
+		/// <summary>
+		/// What went wrong with the last input recording or replay (empty when nothing did)
+		/// </summary>
+		std::string InputLogError();
+
+		/// <summary>
+		/// An input event as SDL reported it. Poll() keeps all of them in the order they came in, so even a key going down and up again within one frame can be seen.
+		/// </summary>
+		struct TInputEvent {
+			Uint32 Type;      // SDL event type (SDL_KEYDOWN, SDL_MOUSEBUTTONUP, etc.)
+			Uint32 Timestamp; // SDL ticks when SDL got the event
+			int Code;         // Scancode for keys, button for mouse buttons
+			int X, Y;         // Mouse position for motion and buttons, amount of scrolling for the wheel
+			bool Repeat;      // Key down generated by holding a key
+		};
+
+		/// <summary>
+		/// The complete input state after one Poll(). Poll() publishes one every time it's done, and other threads can read them without ever waiting for Poll() (nor Poll() for them).
+		/// </summary>
+		struct TInputSnapshot {
+			uint64 Frame;  // Counts every Poll() since the program started
+			Uint32 Ticks;  // SDL ticks when Poll() was done
+			uint64
+				KeyDownBits[SDL_NUM_SCANCODES / 64], // By scancode
+				KeyHitBits[SDL_NUM_SCANCODES / 64];
+			bool
+				ButDown[16],
+				ButHit[16],
+				ButReleased[16];
+			int
+				MouseX,
+				MouseY,
+				WheelY;
+			bool AppTerminate;
+			char Text[128]; // Everything typed during this Poll() (UTF-8), needs SDL_StartTextInput()
+
+			bool KeyDown(SDL_Scancode c) const;
+			bool KeyHit(SDL_Scancode c) const;
+			bool KeyDown(SDL_KeyCode c) const;
+			bool KeyHit(SDL_KeyCode c) const;
+			bool MouseDown(int c) const;
+			bool MouseHit(int c) const;
+			bool MouseReleased(int c) const;
+		};
+
+		/// <summary>
+		/// Frame number of the newest snapshot (0 when Poll() wasn't called yet)
+		/// </summary>
+		uint64 LatestInputFrame();
+
+		/// <summary>
+		/// Copies the newest input snapshot. Safe to call from any thread.
+		/// </summary>
+		/// <returns>False if Poll() wasn't called yet</returns>
+		bool GetInputSnapshot(TInputSnapshot& Snap);
+
+		/// <summary>
+		/// Copies the snapshot of a specific frame. Only the last 16 are kept. Safe to call from any thread.
+		/// </summary>
+		/// <returns>False if that frame is not there (yet)</returns>
+		bool GetInputSnapshot(TInputSnapshot& Snap, uint64 Frame);
+
+		/// <summary>
+		/// All keyboard and mouse events the last Poll() got, oldest first
+		/// </summary>
+		const std::vector<TInputEvent>& InputEvents();
+
+		/// <summary>
+		/// Number of times a key went down during the last Poll() (key repeat not counted)
+		/// </summary>
+		int KeyHitCount(SDL_KeyCode c);
+
+		/// <summary>
+		/// Turns measuring the time from input to the frame showing it on or off. Turning it on throws away the earlier samples.
+		/// Every input event is paired with the first frame presented after the Poll() that got it. So InputSubmitted() and InputPresented() must be called when a frame is handed over and when it's on the screen. With TQSG just let Flip() do that: TQSG::AddPresentHooks("TQSE", TQSE::InputSubmitted, TQSE::InputPresented);
+		/// </summary>
+		void InputLatency(bool on);
+		bool InputLatency();
+
+		/// <summary>
+		/// Tells the latency measuring a frame is handed over to be presented. All input polled since the previous frame belongs to it.
+		/// </summary>
+		void InputSubmitted();
+
+		/// <summary>
+		/// Tells the latency measuring the oldest frame handed over is on the screen now. May be called from another thread.
+		/// </summary>
+		void InputPresented();
+
+		/// <summary>
+		/// Number of latency samples kept (the last 4096 at most)
+		/// </summary>
+		size_t InputLatencySamples();
+
+		/// <summary>
+		/// Input to present latency in ticks below which the given percentage of the samples fall (50 for the median, 99 for the worst but a few)
+		/// </summary>
+		Uint32 InputLatencyPercentile(double p);
+
 		bool Yes(std::string question);
 		void Notify(std::string message);
 
@@ -32,6 +32,9 @@
 #endif
 #include <SlyvGINIE.hpp>
 #include <JCR6_Core.hpp>
+#include <functional>
+#include <atomic>
+#include <mutex>
 
 namespace Slyvina {
 	namespace TQSG {
@@ -50,6 +53,12 @@ namespace Slyvina {
 		typedef std::unique_ptr<_____TIMAGEFONT> TUImageFont; // A unique pointer to use for images.
 
 
+		class _____TCANVAS; // NEVER USE THIS TYPE DIRECTLY! ONLY USE 'TCanvas' or 'TUCanvas' in stead!
+		typedef std::shared_ptr<_____TCANVAS> TCanvas;
+		typedef std::unique_ptr<_____TCANVAS> TUCanvas;
+
+		struct TDrawState; // See TQSG_DrawList.hpp
+
 		typedef void (*TQSG_PanicType)(std::string errormessage);
 
 		class TQAltPic;
@@ -97,13 +106,76 @@ namespace Slyvina {
 		};
 		enum BlitzBlend { ALPHA = 3, ADDITIVE = 4 };
 
+		/// <summary>
+		/// Collects textured quads which all use the same texture and blend mode and sends them to SDL as one single geometry call.
+		/// Coordinates given to Add() are true renderer coordinates, so origin, hotspots and alt screen settings must already be applied (the BatchDraw and BatchXDraw methods of images will do that for you).
+		/// </summary>
+		class TQuadBatch {
+		private:
+			SDL_Texture* _Tex{ nullptr };
+			SDL_BlendMode _Blend{ SDL_BLENDMODE_BLEND };
+			int _TexW{ 0 }, _TexH{ 0 };
+			std::vector<SDL_Vertex> _Vertices{};
+			std::vector<int> _Indices{};
+		public:
+			/// <summary>
+			/// Makes sure the batch will use this texture and blend mode. When the batch was filled with a different texture or blend mode, it will be flushed first.
+			/// </summary>
+			void Start(SDL_Texture* Tex, Blend _blend);
+
+			/// <summary>
+			/// Adds a quad. When Source is null the full texture will be used. Rotation works the same as SDL_RenderCopyEx.
+			/// </summary>
+			void Add(const SDL_FRect& Target, const SDL_Rect* Source, byte r, byte g, byte b, byte a, double angle = 0, SDL_FPoint center = { 0,0 }, int flip = SDL_FLIP_NONE);
+
+			/// <summary>
+			/// Sends all collected quads to the renderer and empties the batch
+			/// </summary>
+			void Flush();
+
+			inline size_t Quads() { return _Vertices.size() / 4; }
+
+			/// <summary>
+			/// Drops the collected quads without drawing them
+			/// </summary>
+			inline void Clear() { _Vertices.clear(); _Indices.clear(); _Tex = nullptr; }
+
+			// Drops whatever was not flushed, as a static batch may outlive the renderer. Always call Flush() yourself.
+			inline ~TQuadBatch() { Clear(); }
+		};
+
 
 		class _____TIMAGE {
 		private:
 			static uint64 img_cnt;
 			uint64 _ID{ ++img_cnt }; // Only serves to make debugging easier on me! (and it will also help with the TQAltPic drivers.
 			std::vector<SDL_Texture*> Textures{};
-			int hotx{ 0 }, hoty{ 0 };
+			std::atomic<int> hotx{ 0 }, hoty{ 0 }; // The render thread reads these while replaying
+			friend class _____TCANVAS; // A canvas lends its texture to an image, so it can be drawn like one
+
+			// What the loader found out about each frame (see ImageLoadTrim(), ImageLoadOpaque() and ImagePrescale())
+			struct __Variant {
+				SDL_Texture* Tex{ nullptr };
+				int
+					W{ 0 },
+					H{ 0 };
+			};
+			struct __FrameInfo {
+				SDL_Rect Area{ 0,0,0,0 }; // Part of the full frame that is in the texture
+				int
+					FullW{ 0 },
+					FullH{ 0 };
+				bool
+					Trimmed{ false },
+					Opaque{ false };
+				std::vector<__Variant> Variants{}; // Half size, quarter size, and so on
+			};
+			std::vector<__FrameInfo> FrameInfo{};
+			SDL_Texture* Prepare(SDL_Surface* Surf, __FrameInfo& Info);
+			void CopyFrame(size_t frame, const SDL_Rect* Part, SDL_FRect Target, const TDrawState& State, double angle = 0, SDL_FPoint center = { 0,0 }, int flip = SDL_FLIP_NONE);
+			Blend FrameBlend(size_t frame, const TDrawState& State);
+			int RawWidth();
+			int RawHeight();
 		public:
 		    inline bool Valid() { return Textures.size()>0; }
 
@@ -176,6 +248,24 @@ namespace Slyvina {
 			/// <param name="frame"></param>
 			void XDraw(int x, int y, int frame = 0);
 
+			/// <summary>
+			/// Does the same as Draw, but puts the result into a batch in stead of sending it to SDL right away.
+			/// </summary>
+			/// <param name="Batch"></param>
+			/// <param name="x"></param>
+			/// <param name="y"></param>
+			/// <param name="frame"></param>
+			void BatchDraw(TQuadBatch& Batch, int x, int y, int frame = 0);
+
+			/// <summary>
+			/// Does the same as XDraw, but puts the result into a batch in stead of sending it to SDL right away.
+			/// </summary>
+			/// <param name="Batch"></param>
+			/// <param name="x"></param>
+			/// <param name="y"></param>
+			/// <param name="frame"></param>
+			void BatchXDraw(TQuadBatch& Batch, int x, int y, int frame = 0);
+
 			/// <summary>
 			/// Tiles an image over an area (this routine is not super stable, but it should do its job.
 			/// </summary>
@@ -188,6 +278,18 @@ namespace Slyvina {
 			/// <param name="aiy"></param>
 			void Tile(int ax, int ay, int w, int h, int frame=0, int aix=0, int aiy=0);
 
+			/// <summary>
+			/// These do the same as the methods above, but use the settings in State in stead of the global ones, and they leave LastError() alone, so the render thread can use them while the game goes on.
+			/// Images with a TQAltPic driver are still drawn by that driver, which only knows the global settings.
+			/// </summary>
+			void Blit(int ax, int ay, int isx, int isy, int iex, int iey, int frame, const TDrawState& State);
+			void StretchDraw(int x, int y, int w, int h, int frame, const TDrawState& State);
+			void Draw(int x, int y, int frame, const TDrawState& State);
+			void XDraw(int x, int y, int frame, const TDrawState& State);
+			void BatchDraw(TQuadBatch& Batch, int x, int y, int frame, const TDrawState& State);
+			void BatchXDraw(TQuadBatch& Batch, int x, int y, int frame, const TDrawState& State);
+			void Tile(int ax, int ay, int w, int h, int frame, int aix, int aiy, const TDrawState& State);
+
 			inline void Hot(int x, int y) {
 				if (AltPic && AltPic->Hot) {
 					AltPic->Hot(this, x, y);;
@@ -197,12 +299,42 @@ namespace Slyvina {
 			}
 			inline void HotCenter() { Hot(Width() / 2, Height() / 2); }
 			inline void HotBottomCenter() { Hot(Width() / 2, Height()); }
+			inline int HotX() { return hotx; }
+			inline int HotY() { return hoty; }
 
 			int Width();
 			int Height();
 
 			void GetFormat(int *width, int *height);
 
+			/// <summary>
+			/// True when the transparent borders of this frame were cut off when loading. Width(), Height() and hotspots still count the full frame.
+			/// </summary>
+			inline bool Trimmed(size_t frame) { return frame < FrameInfo.size() && FrameInfo[frame].Trimmed; }
+
+			/// <summary>
+			/// True when the loader found no (partly) transparent pixel in this frame. Such frames are drawn without blending when the blend mode is ALPHA and the alpha is 255.
+			/// </summary>
+			inline bool Opaque(size_t frame) { return frame < FrameInfo.size() && FrameInfo[frame].Opaque; }
+
+			/// <summary>
+			/// Only needed when you draw the texture of a frame yourself (GetFrame()). Target (and the rotation center within it) is meant for the full frame and will be turned into the rect the texture must go to. Source becomes the part of the texture to use.
+			/// When Part is set, only that part of the full frame is drawn. For frames that are not trimmed Target is left alone.
+			/// </summary>
+			/// <returns>False when nothing visible is left to draw</returns>
+			bool TrimRect(size_t frame, SDL_FRect& Target, SDL_Rect& Source, SDL_FPoint* Center = nullptr, int Flip = SDL_FLIP_NONE, const SDL_Rect* Part = nullptr);
+
+			/// <summary>
+			/// True when a frame was trimmed or got prescaled copies, meaning that drawing its texture yourself must go through MapFrame().
+			/// </summary>
+			inline bool Mapped(size_t frame) { return frame < FrameInfo.size() && (FrameInfo[frame].Trimmed || FrameInfo[frame].Variants.size()); }
+
+			/// <summary>
+			/// Does the same as TrimRect(), but also picks the prescaled copy best fit for the size Target has, and sets Source for that copy.
+			/// </summary>
+			/// <returns>The texture to draw (nullptr when there's nothing to draw)</returns>
+			SDL_Texture* MapFrame(size_t frame, SDL_FRect& Target, SDL_Rect& Source, SDL_FPoint* Center = nullptr, int Flip = SDL_FLIP_NONE, const SDL_Rect* Part = nullptr);
+
 			TQAltPic* AltPic{ nullptr };
 
 			inline _____TIMAGE() {} // Just to avoid some crap
@@ -212,6 +344,97 @@ namespace Slyvina {
 			~_____TIMAGE();
 		};
 
+		/// <summary>
+		/// Called when the content of a canvas got lost (for example when the graphics driver reset its render targets). The canvas is already the draw target and cleared when this is called.
+		/// </summary>
+		typedef void (*TQSG_CanvasRestore)(_____TCANVAS* Canvas);
+
+		/// <summary>
+		/// A texture you can draw on. Make it the draw target with PushTarget() and all TQSG drawing goes into it, until PopTarget() is called. After that it can be drawn just like an image.
+		/// Canvases of the same size share a pool of textures, so creating and disposing them often is cheap.
+		/// </summary>
+		class _____TCANVAS {
+		private:
+			int
+				_W{ 0 },
+				_H{ 0 };
+			SDL_Texture* _Tex{ nullptr };
+			uint64
+				_Session{ 0 },
+				_TargetResets{ 0 },
+				_DeviceResets{ 0 };
+			bool
+				_Lost{ true },
+				_Restoring{ false };
+			TImage _Img{ nullptr };
+			bool Check();
+			friend bool PushTarget(_____TCANVAS* Canvas);
+			friend bool BeginScene();
+		public:
+			/// <summary>
+			/// When set, this is called to redraw the content after it got lost. Without it, Lost() will tell you when you must redraw it yourself.
+			/// </summary>
+			TQSG_CanvasRestore OnRestore{ nullptr };
+
+			/// <summary>
+			/// Free to use for anything you like (handy for OnRestore).
+			/// </summary>
+			void* Data{ nullptr };
+
+			inline int Width() { return _W; }
+			inline int Height() { return _H; }
+
+			/// <summary>
+			/// True when the content is not there (anymore). This is the case for a new canvas and after the driver threw the render targets away when no OnRestore was set. Pushing the canvas as target resets this.
+			/// </summary>
+			bool Lost();
+
+			/// <summary>
+			/// Fills the entire canvas with this colour (by default fully transparent)
+			/// </summary>
+			void Clear(byte r = 0, byte g = 0, byte b = 0, byte a = 0);
+
+			/// <summary>
+			/// The texture of the canvas. It can change after the driver was reset, so don't keep it.
+			/// </summary>
+			SDL_Texture* GetTexture();
+
+			/// <summary>
+			/// An image showing the content of the canvas, for everything the draw methods below don't cover (hotspots, Blit, Tile, draw lists, scenes, and so on).
+			/// It does not own the texture, so it only works as long as the canvas exists.
+			/// </summary>
+			TImage Image();
+
+			void Draw(int x, int y);
+			void XDraw(int x, int y);
+			void StretchDraw(int x, int y, int w, int h);
+
+			_____TCANVAS(int w, int h);
+			~_____TCANVAS();
+		};
+
+		TCanvas CreateCanvas(int w, int h);
+		TUCanvas CreateUCanvas(int w, int h);
+
+		/// <summary>
+		/// Makes a canvas the draw target. Alt screen settings are suspended inside a canvas (one pixel is one pixel), and pushed viewports and clip rects of the screen don't apply.
+		/// Targets are stacked, so a canvas can be drawn into another one. Always pop all targets before calling Flip().
+		/// </summary>
+		/// <returns>True if succesful</returns>
+		bool PushTarget(_____TCANVAS* Canvas);
+		inline bool PushTarget(TCanvas Canvas) { return PushTarget(Canvas.get()); }
+		inline bool PushTarget(TUCanvas& Canvas) { return PushTarget(Canvas.get()); }
+
+		/// <summary>
+		/// Goes back to the draw target that was active before the last PushTarget()
+		/// </summary>
+		void PopTarget();
+
+		/// <summary>
+		/// Disposes all textures no canvas is using at the moment
+		/// </summary>
+		void ClearCanvasPool();
+
 		enum class Align { Left = 0, Top = 0, Right = 1, Bottom = 1, Center = 2 };
 		class _____TIMAGEFONTCHAR;
 		class _____TIMAGEFONT {
@@ -228,12 +451,18 @@ namespace Slyvina {
 			Units::UGINIE Alt{nullptr};
 			std::string pathprefix{ "" };
 			JCR6::JT_Dir FntRes{ nullptr };
-			void TW(std::string Text, bool Draw, int& x, int& y);
+			void TW(std::string Text, bool Draw, int& x, int& y, const TDrawState* State = nullptr);
 			bool spaceavg{ true };
-			int spacewidth{ 0 };
+			std::atomic<int> spacewidth{ 0 };
+			std::mutex CharMutex; // Guards CharPics, as the render thread may load characters too
+			uint32 CharCount{ 0 }, CharTotal{ 0 };
 		public:
 			int TabWidth{ 40 };
 			void Text(std::string Text, int x, int y, Align ax = Align::Left, Align ay = Align::Top);
+			/// <summary>
+			/// Same as above, but with the settings in State in stead of the global ones, and without touching LastError()
+			/// </summary>
+			void Text(std::string Text, int x, int y, Align ax, Align ay, const TDrawState& State);
 			void Dark(std::string Text, int x, int y, Align ax = Align::Left, Align ay = Align::Top);
 			int Width(std::string Text);
 			int Height(std::string Text);
@@ -264,6 +493,11 @@ namespace Slyvina {
 		/// <param name="alpha"></param>
 		void SetAlphaD(double);
 
+		/// <summary>
+		/// Get the alpha value currently used for rendering
+		/// </summary>
+		byte GetAlpha();
+
 		/// <summary>
 		/// Set the color value for rendering
 		/// </summary>
@@ -297,6 +531,19 @@ namespace Slyvina {
 		/// </summary>
 		void CloseGraphics();
 
+		typedef void (*TQSG_CloseHook)();
+
+		/// <summary>
+		/// Adds a function called right before the renderer goes down (CloseGraphics(), opening a new screen, or the end of the program), so canvases and textures kept in static variables can be released while that's still possible. Adding a hook with a name already in use replaces the old one.
+		/// </summary>
+		void AddCloseHook(std::string Name, TQSG_CloseHook Hook);
+		void RemoveCloseHook(std::string Name);
+
+		/// <summary>
+		/// Direct pointer to the SDL renderer of the graphics screen (nullptr when there is none). Only use this if you know what you are doing!
+		/// </summary>
+		SDL_Renderer* GetRenderer();
+
 		/// <summary>
 		/// Creates a window of the given size and height
 		/// </summary>
@@ -328,6 +575,7 @@ namespace Slyvina {
 		/// <param name="Saturation"></param>
 		/// <param name="Value"></param>
 		void SetCLSColorHSV(double, double, double);
+		void GetCLSColor(byte& r, byte& g, byte& b);
 
 		/// <summary>
 		/// Clear the (graphics) screen
@@ -372,9 +620,12 @@ namespace Slyvina {
 		/// <param name="s"></param>
 		inline void SetScale(double s) { SetScale(s, s); }
 
+		void GetScale(double& x, double& y);
+
 
 		void SetOrigin(int x, int y);
 		inline void SetOrigin() { SetOrigin(0, 0); }
+		void GetOrigin(int& x, int& y);
 
 		/// <summary>
 		/// Will wait a certain number of ticks since the last WaitMinTicks (called automatically by Flip(). See that function for more information).
@@ -388,6 +639,119 @@ namespace Slyvina {
 		/// <param name="minticks">By default Flip will wait up to 26 ticks since the last Flip, setting this parameter will change that. Please note, all changes are 'permanent' until the next change</param>
 		void Flip(int minticks=-1);
 
+		/// <summary>
+		/// Turns dynamic resolution on or off. When on, everything drawn between BeginScene() and EndScene() goes into an offscreen picture. Its resolution drops when frames take longer than they may, and climbs back when there's time to spare.
+		/// EndScene() stretches that picture over the window in one go. Everything drawn after that (like the HUD and text) is drawn at the full resolution.
+		/// Can't be combined with the render thread or dirty rect mode.
+		/// </summary>
+		/// <param name="Floor">The resolution never goes below this part of the real one</param>
+		/// <param name="TargetTicks">Time a frame may take. With 0 the value set by WaitMinTicks() (or Flip()) is used.</param>
+		bool DynamicResolution(bool on, double Floor = 0.5, int TargetTicks = 0);
+		bool DynamicResolution();
+
+		/// <summary>
+		/// The part of the real resolution scenes are drawn at right now (1 when dynamic resolution is off)
+		/// </summary>
+		double DynamicResolutionScale();
+
+		/// <summary>
+		/// Starts drawing the scene. Coordinates stay the same as always, TQSG does the scaling. When dynamic resolution is off, this does nothing and returns false, so everything goes straight to the screen.
+		/// Viewports and clip rects pushed before the scene began don't count within it.
+		/// </summary>
+		bool BeginScene();
+
+		/// <summary>
+		/// Puts the scene on the screen. Flip() does this itself when you forgot.
+		/// </summary>
+		void EndScene();
+
+		typedef void (*TQSG_FlipHook)();
+
+		/// <summary>
+		/// Adds a function Flip() calls right before the frame is presented, so while the finished frame can still be read from the renderer. Hooks are called in alphabetical order of their names. Adding a hook with a name already in use replaces the old one.
+		/// When the render thread runs, the hooks are called on that thread.
+		/// </summary>
+		void AddFlipHook(std::string Name, TQSG_FlipHook Hook);
+		void RemoveFlipHook(std::string Name);
+
+		/// <summary>
+		/// Adds a pair of functions Flip() calls around presenting a frame. Submitted is called when a frame is handed over to be presented (with the render thread that's on the thread calling Flip(), when the frame goes to the render thread), Presented right after the frame went to the screen (with the render thread on that thread). Either one may be nullptr.
+		/// Handy to measure latency, like with TQSE: AddPresentHooks("TQSE", TQSE::InputSubmitted, TQSE::InputPresented);
+		/// </summary>
+		void AddPresentHooks(std::string Name, TQSG_FlipHook Submitted, TQSG_FlipHook Presented);
+		void RemovePresentHooks(std::string Name);
+
+		/// <summary>
+		/// Calls Job for every part from 0 till Parts-1, spread over TQSG's worker threads (one per core, started on first use and kept till the end of the program), and returns when all parts are done. The calling thread does its share as well.
+		/// Jobs may not draw, nor call ParallelRun() themselves.
+		/// </summary>
+		void ParallelRun(size_t Parts, std::function<void(size_t)> Job);
+
+		/// <summary>
+		/// Called by Flip() in dirty rect mode for every area that must be redrawn. The clip rect is already set to that area and it has already been cleared with the CLS color. Area is in true screen pixels.
+		/// </summary>
+		typedef void (*TQSG_DirtyRedraw)(const SDL_Rect& Area);
+
+		/// <summary>
+		/// In dirty rect mode all drawing goes into a back buffer which is kept between frames. Flip() only redraws the areas marked with MarkDirty() and when nothing was marked it does not present anything at all.
+		/// Either draw everything in the Redraw function (drawing outside the area is clipped away by SDL anyway), or leave that out and draw the changes yourself before calling Flip().
+		/// This mode cannot be used together with the render thread.
+		/// </summary>
+		/// <returns>True if succesful</returns>
+		bool DirtyRectMode(bool on, TQSG_DirtyRedraw Redraw = nullptr);
+		bool DirtyRectMode();
+
+		/// <summary>
+		/// Marks an area to be redrawn at the next Flip(). Origin and alt screen settings are taken into account, so just use the same coordinates as when drawing.
+		/// </summary>
+		void MarkDirty(int x, int y, int w, int h);
+
+		/// <summary>
+		/// Makes the next Flip() redraw the entire screen
+		/// </summary>
+		void MarkAllDirty();
+
+		/// <summary>
+		/// In idle mode Flip() doesn't present anything when nothing changed since the last frame. In stead it sleeps until an event comes in, a WakeIn() deadline passes or MaxWait ticks have gone by, so static screens (like menus) hardly use any CPU.
+		/// Input, window events, user events, MarkChanged(), MarkDirty() and MarkAllDirty() all count as changes. Use Changed() to skip drawing frames which won't be shown anyway.
+		/// Idle mode does nothing while the render thread runs.
+		/// </summary>
+		/// <param name="MaxWait">Longest time Flip() may sleep. 0 means it can sleep for as long as nothing happens.</param>
+		bool IdleMode(bool on, int MaxWait = 1000);
+		bool IdleMode();
+
+		/// <summary>
+		/// Tells idle mode the next frame must be shown
+		/// </summary>
+		void MarkChanged();
+
+		/// <summary>
+		/// Makes sure idle mode shows a frame again within the given number of ticks. Handy for animations, blinking cursors and such. When more deadlines are set, the earliest counts.
+		/// </summary>
+		void WakeIn(Uint32 ticks);
+
+		/// <summary>
+		/// Returns true when the next Flip() is going to show the frame. Always true when idle mode is off, unless the window is minimized or hidden.
+		/// </summary>
+		bool Changed();
+
+		/// <summary>
+		/// Frames per second Flip() allows while the window doesn't have the focus (0 means no limit). (Default 10)
+		/// While the window is minimized or hidden, Flip() shows nothing at all and just sleeps till something happens (except when the render thread runs, then it only sleeps). The window state is what SDL knows after the last time events were polled.
+		/// </summary>
+		void BackgroundFPS(int fps);
+		int BackgroundFPS();
+
+		/// <summary>
+		/// True while Flip() doesn't show anything, as the window is minimized or hidden
+		/// </summary>
+		bool Suspended();
+
+		/// <summary>
+		/// SDL ticks minus all time the window was minimized or hidden. When game timing uses this, nothing jumps ahead when the player comes back.
+		/// </summary>
+		Uint32 ActiveTicks();
+
 		/// <summary>
 		/// Draw a line
 		/// </summary>
@@ -476,6 +840,11 @@ namespace Slyvina {
 		/// </summary>
 		void Rotate(double degrees = 0);
 
+		/// <summary>
+		/// Get the current rotation in degrees
+		/// </summary>
+		double GetRotate();
+
 		/// <summary>
 		/// Set the rotation based on randians. (NOTE! SDL2 uses degrees for rotation, so it will NOT be faster to use this in stead of degrees. Only use this if radians is what you got from the start.
 		/// </summary>
@@ -490,6 +859,81 @@ namespace Slyvina {
 		int ASX(int x);
 		int ASY(int y);
 
+		/// <summary>
+		/// Gets the factors by which the alt screen settings multiply coordinates and sizes (1 when no alt screen is set). Handy when you need float precision.
+		/// In GPU alt screen mode these are 1 as well, as the renderer does the multiplying then.
+		/// </summary>
+		void AltScreenRatio(double& x, double& y);
+
+		/// <summary>
+		/// When on, the alt screen settings are handed to the renderer as a scale, so coordinates are no longer converted (and rounded) one by one by every drawing function. Tiles then also line up without seams.
+		/// ASX(), ASY() and the A... functions keep working the same way, and so do all functions working with true screen pixels (Line, Rect, Plot, Circle, TrueDraw). (Default off)
+		/// </summary>
+		void AltScreenGPU(bool on);
+		bool AltScreenGPU();
+
+		/// <summary>
+		/// Turns a frame of an image into the mouse cursor. The system draws it, so it follows the mouse at the refresh rate of the display, no matter how long frames take. The hotspot of the image becomes the spot that clicks, and the alt screen settings are taken into account.
+		/// Cursors are kept per image, frame and size, so for an animated cursor just call this with the frame you need every time. The image stays in memory as long as its cursors are kept.
+		/// </summary>
+		/// <returns>True if succesful</returns>
+		bool ImageCursor(TImage Img, int frame = 0);
+
+		/// <summary>
+		/// Brings back the cursor of the system
+		/// </summary>
+		void DefaultCursor();
+
+		/// <summary>
+		/// Brings back the cursor of the system and throws away all cursors ImageCursor() made
+		/// </summary>
+		void ClearCursorCache();
+
+		/// <summary>
+		/// Makes all drawing happen inside this area until PopViewport() is called. Coordinate (0,0) is then the top-left corner of the viewport. Alt screen settings are taken into account, the origin is not.
+		/// A clip rect pushed before keeps clipping the same area of the screen inside the viewport.
+		/// Viewports and clip rects share one stack, so always pop them in the reverse order they were pushed.
+		/// </summary>
+		void PushViewport(int x, int y, int w, int h);
+		void PopViewport();
+
+		/// <summary>
+		/// Cuts off all drawing outside this area (relative to the current viewport) until PopClip() is called. When another clip rect is active, only the part within both rects remains visible.
+		/// </summary>
+		void PushClip(int x, int y, int w, int h);
+		void PopClip();
+
+		/// <summary>
+		/// Number of viewports and clip rects currently pushed
+		/// </summary>
+		size_t ViewDepth();
+
+		/// <summary>
+		/// Returns false when an area is completely outside the current viewport and clip rect (origin and alt screen settings are taken into account).
+		/// All drawing functions already do this check themselves, but it can save you the trouble of preparing something that would never be seen.
+		/// </summary>
+		bool Visible(int x, int y, int w, int h);
+
+		/// <summary>
+		/// When on, fully transparent borders are cut off the frames of images loaded from then on, so less pixels have to be pushed when drawing them. Width(), Height(), hotspots and draw positions stay exactly as if the borders were still there. (Default off)
+		/// Images made by alt pic drivers are not affected.
+		/// </summary>
+		void ImageLoadTrim(bool on);
+		bool ImageLoadTrim();
+
+		/// <summary>
+		/// When on, images loaded from then on are checked for frames without any transparency. Those are drawn without blending when the blend mode is ALPHA and the alpha is 255. Images with an alpha channel have to be converted and scanned for that, which makes loading slower. (Default off)
+		/// </summary>
+		void ImageLoadOpaque(bool on);
+		bool ImageLoadOpaque();
+
+		/// <summary>
+		/// When on, images loaded from then on also get copies at half size, quarter size and so on, down to the size they'll be drawn at. Drawing them smaller than they are then uses the smallest copy that is still big enough, which looks better and is lighter on the video card. (Default off)
+		/// Best set after SetAltScreen() and SetScale(), as the alt screen ratio times the scale tells how small the copies should go. When you know better, set Factor yourself (0.25 means down to a quarter).
+		/// </summary>
+		void ImagePrescale(bool on, double Factor = 0);
+		bool ImagePrescale();
+
 
 		/// <summary>
 		/// Load an image and assigns it to a shared pointer.
@@ -37,6 +37,15 @@ namespace Slyvina {
 		void DrawBlopPlasma(int NumBlops = 0, bool Chat = false);
 		void DrawBlopPlasma(double PlasR = 1, double PlasG = 1, double PlasB = 1, int  NumBlops = 0, bool Chat = false);
 
+		/// <summary>
+		/// Renders the plasma into an offscreen texture at a fraction of PlasmaWidth x PlasmaHeight, which is then stretched over the plasma area with linear filtering.
+		/// The plasma is so soft that this is hardly visible, but it saves a lot of fill-rate.
+		/// </summary>
+		/// <param name="Fraction">Size of the offscreen texture relative to the plasma (0.25 means a quarter of the width and the height). 1 is full resolution.</param>
+		/// <param name="EveryNthFrame">Only really renders the plasma once every so many calls to DrawBlopPlasma. The blops still move on every call, the calls in between just show the last result again.</param>
+		/// <remarks>With both values at 1 (the default) the plasma is drawn directly onto the screen like before.</remarks>
+		void BlopPlasmaResolution(double Fraction = 1, int EveryNthFrame = 1);
+
 		void SetPlasmaBlop(std::string File);
 		void SetPlasmaBlop(JCR6::JT_Dir J, std::string Entry);
 		void SetPlasmaBlop(std::string JCRFile, std::string Entry);
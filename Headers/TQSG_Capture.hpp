@@ -0,0 +1,96 @@
+// License:
+// 	TQSL/Headers/TQSG_Capture.hpp
+// 	Tricky's Quick SDL2 Graphics - Screen capture (header)
+// 	version: 26.10.19
+//
+// 	Copyright (C) 2026 Jeroen P. Broks
+//
+// 	This software is provided 'as-is', without any express or implied
+// 	warranty.  In no event will the authors be held liable for any damages
+// 	arising from the use of this software.
+//
+// 	Permission is granted to anyone to use this software for any purpose,
+// 	including commercial applications, and to alter it and redistribute it
+// 	freely, subject to the following restrictions:
+//
+// 	1. The origin of this software must not be misrepresented; you must not
+// 	   claim that you wrote the original software. If you use this software
+// 	   in a product, an acknowledgment in the product documentation would be
+// 	   appreciated but is not required.
+// 	2. Altered source versions must be plainly marked as such, and must not be
+// 	   misrepresented as being the original software.
+// 	3. This notice may not be removed or altered from any source distribution.
+// End License
+
+#pragma once
+#include "TQSG.hpp"
+
+namespace Slyvina {
+	namespace TQSG {
+
+		/*
+		* Screenshots and frame recording.
+		* Frames are read from the renderer by Flip() (through a flip hook) into a ring of buffers.
+		* Encoding and writing them to disk happens on background threads, so Flip() only has to wait for the read itself.
+		* When the background threads can't keep up and all buffers are in use, the drop policy decides what happens.
+		*/
+
+		enum class CaptureFormat {
+			PNG, // Needs SDL_image
+			Raw  // Just the pixels, 4 bytes per pixel, R,G,B,A, row by row. When recording, the size is put in the file names.
+		};
+
+		enum class CaptureDrop {
+			Newest, // The new frame is not captured (default)
+			Oldest, // The oldest frame not being encoded yet is thrown away to make room
+			Wait    // Flip() waits until there's room. Nothing is lost, but the game slows down
+		};
+
+		/// <summary>
+		/// Number of buffers frames can wait in for being encoded. Can only be changed while nothing is being captured. (Default 8)
+		/// </summary>
+		void CaptureDepth(size_t Buffers);
+
+		/// <summary>
+		/// Number of threads encoding and writing frames. Can only be changed while nothing is being captured. (Default 2)
+		/// </summary>
+		void CaptureThreads(int Threads);
+
+		void CapturePolicy(CaptureDrop Policy);
+
+		/// <summary>
+		/// Saves the next frame shown by Flip(). In idle mode that frame is shown even when nothing changed.
+		/// </summary>
+		/// <returns>True when the request was accepted (a graphics screen must be open)</returns>
+		bool Screenshot(std::string File, CaptureFormat Format = CaptureFormat::PNG);
+
+		/// <summary>
+		/// Saves every frame shown by Flip() (or every so many frames) as Prefix000001.png, Prefix000002.png and so on.
+		/// </summary>
+		/// <param name="EveryNth">Only capture one out of this many frames</param>
+		bool StartRecording(std::string Prefix, CaptureFormat Format = CaptureFormat::PNG, int EveryNth = 1);
+
+		/// <summary>
+		/// Stops recording. Frames already captured will still be written.
+		/// </summary>
+		void StopRecording();
+
+		bool Recording();
+
+		/// <summary>
+		/// Waits until all captured frames have been written to disk.
+		/// </summary>
+		void CaptureFinish();
+
+		/// <summary>
+		/// Frames written / frames dropped since the last StartRecording()
+		/// </summary>
+		uint64 CaptureWritten();
+		uint64 CaptureDropped();
+
+		/// <summary>
+		/// Error message of the last failed write (empty if there was none)
+		/// </summary>
+		std::string CaptureError();
+	}
+}
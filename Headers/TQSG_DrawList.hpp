@@ -0,0 +1,216 @@
+// License:
+// 	TQSL/Headers/TQSG_DrawList.hpp
+// 	Tricky's Quick SDL2 Graphics - Draw lists (header)
+// 	version: 26.10.19
+//
+// 	Copyright (C) 2026 Jeroen P. Broks
+//
+// 	This software is provided 'as-is', without any express or implied
+// 	warranty.  In no event will the authors be held liable for any damages
+// 	arising from the use of this software.
+//
+// 	Permission is granted to anyone to use this software for any purpose,
+// 	including commercial applications, and to alter it and redistribute it
+// 	freely, subject to the following restrictions:
+//
+// 	1. The origin of this software must not be misrepresented; you must not
+// 	   claim that you wrote the original software. If you use this software
+// 	   in a product, an acknowledgment in the product documentation would be
+// 	   appreciated but is not required.
+// 	2. Altered source versions must be plainly marked as such, and must not be
+// 	   misrepresented as being the original software.
+// 	3. This notice may not be removed or altered from any source distribution.
+// End License
+
+#pragma once
+#include "TQSG.hpp"
+
+namespace Slyvina {
+	namespace TQSG {
+
+		/*
+		* A draw list records drawing requests in stead of executing them.
+		* Recording does not touch any TQSG or SDL state at all, so every thread can fill its own list.
+		* Only replaying has to happen on the thread owning the renderer (mostly the main thread).
+		* Each list has its own colour, blend, scale, rotation and origin settings which work the same way as the global ones.
+		*/
+
+		class _____TDRAWLIST; // NEVER USE THIS TYPE DIRECTLY! ONLY USE 'TDrawList' or 'TUDrawList' in stead!
+		typedef std::shared_ptr<_____TDRAWLIST> TDrawList;
+		typedef std::unique_ptr<_____TDRAWLIST> TUDrawList;
+
+		enum class DrawCommand { Draw, XDraw, StretchDraw, Tile, Blit, Text, Line, Rect, Circle, Plot, Cls };
+
+		struct TDrawState {
+			byte
+				r{ 255 },
+				g{ 255 },
+				b{ 255 },
+				alpha{ 255 };
+			Blend
+				blend{ Blend::ALPHA };
+			double
+				scalex{ 1 },
+				scaley{ 1 },
+				rotatedeg{ 0 };
+			int
+				originx{ 0 },
+				originy{ 0 };
+
+			bool operator==(const TDrawState& o) const;
+			inline bool operator!=(const TDrawState& o) const { return !(*this == o); }
+
+			/// <summary>
+			/// Copies the global TQSG settings into this state
+			/// </summary>
+			void Grab();
+
+			/// <summary>
+			/// Makes this state the global TQSG setting
+			/// </summary>
+			void Apply() const;
+		};
+
+		/*
+		* Drawing with a draw state in stead of the global settings.
+		* These neither read nor change the global colour/blend/scale/rotation/origin settings, nor LastError(), so the render thread can use them while the game goes on.
+		* Just like their regular versions, these work in true screen coordinates and ignore the origin and scale.
+		*/
+		void Line(int start_x, int start_y, int end_x, int end_y, const TDrawState& State);
+		void Rect(int x, int y, int w, int h, bool open, const TDrawState& State);
+		void Circle(int center_x, int center_y, int radius, int segments, const TDrawState& State);
+		void Plot(int x, int y, const TDrawState& State);
+
+		/// <summary>
+		/// Clears the screen (or the current target) with this colour in stead of the one set with SetCLSColor()
+		/// </summary>
+		void Cls(byte r, byte g, byte b);
+
+		struct TDrawRecord {
+			DrawCommand Command{ DrawCommand::Draw };
+			TDrawState State{};
+			TImage Img{ nullptr }; // Keeps shared images alive until the list has been replayed
+			_____TIMAGE* ImgPtr{ nullptr };
+			TImageFont Font{ nullptr };
+			_____TIMAGEFONT* FontPtr{ nullptr };
+			std::string Txt{ "" };
+			int
+				i[8]{ 0,0,0,0,0,0,0,0 };
+			int frame{ 0 };
+			bool open{ false };
+			Align
+				ax{ Align::Left },
+				ay{ Align::Top };
+		};
+
+		class _____TDRAWLIST {
+		private:
+			std::vector<TDrawRecord> _Records{};
+			TDrawState _State{};
+			TDrawRecord& Rec(DrawCommand c);
+		public:
+			/// <summary>
+			/// Lists are replayed in ascending order of this value. Lists with the same value keep the order in which they were submitted.
+			/// </summary>
+			int Order{ 0 };
+
+			inline void SetColor(byte r, byte g, byte b) { _State.r = r; _State.g = g; _State.b = b; }
+			inline void SetColor(byte r, byte g, byte b, byte a) { SetColor(r, g, b); _State.alpha = a; }
+			inline void SetAlpha(byte a) { _State.alpha = a; }
+			inline void SetBlend(Blend _blend) { _State.blend = _blend; }
+			inline void SetScale(double x, double y) { _State.scalex = x; _State.scaley = y; }
+			inline void SetScale(double s) { SetScale(s, s); }
+			inline void Rotate(double degrees = 0) { _State.rotatedeg = degrees; }
+			inline void SetOrigin(int x = 0, int y = 0) { _State.originx = x; _State.originy = y; }
+
+			/// <summary>
+			/// Sets all settings of this list at once. (Handy to start from the global settings with GrabbedState())
+			/// </summary>
+			inline void SetState(TDrawState s) { _State = s; }
+			inline TDrawState GetState() { return _State; }
+
+			void Draw(TImage Img, int x, int y, int frame = 0);
+			void Draw(TUImage& Img, int x, int y, int frame = 0);
+			void XDraw(TImage Img, int x, int y, int frame = 0);
+			void XDraw(TUImage& Img, int x, int y, int frame = 0);
+			void StretchDraw(TImage Img, int x, int y, int w, int h, int frame = 0);
+			void StretchDraw(TUImage& Img, int x, int y, int w, int h, int frame = 0);
+			void Tile(TImage Img, int x, int y, int w, int h, int frame = 0, int ix = 0, int iy = 0);
+			void Tile(TUImage& Img, int x, int y, int w, int h, int frame = 0, int ix = 0, int iy = 0);
+			void Blit(TImage Img, int x, int y, int isx, int isy, int iex, int iey, int frame = 0);
+			void Blit(TUImage& Img, int x, int y, int isx, int isy, int iex, int iey, int frame = 0);
+			void Text(TImageFont Fnt, std::string Txt, int x, int y, Align ax = Align::Left, Align ay = Align::Top);
+			void Text(TUImageFont& Fnt, std::string Txt, int x, int y, Align ax = Align::Left, Align ay = Align::Top);
+			void Line(int start_x, int start_y, int end_x, int end_y);
+			void Rect(int x, int y, int w, int h, bool open = false);
+			void Circle(int center_x, int center_y, int radius, int segments = 200);
+			void Plot(int x, int y);
+			/// <summary>
+			/// Clears with the given colour. Like all other settings of a list, the global one (SetCLSColor()) is not used.
+			/// </summary>
+			void Cls(byte r = 0, byte g = 0, byte b = 0);
+
+			/// <summary>
+			/// Removes all recorded requests. The settings and the order will remain the same.
+			/// </summary>
+			inline void Clear() { _Records.clear(); }
+			inline size_t Size() { return _Records.size(); }
+
+			/// <summary>
+			/// Executes all recorded requests, each with the settings it was recorded with. The global TQSG settings are neither used nor changed.
+			/// Only do this on the thread the graphics screen was created on (or the render thread, which does this for you).
+			/// </summary>
+			/// <param name="Batch">When set, image draws with the same texture will be sent to SDL together. The batch is not flushed at the end, that's up to the caller.</param>
+			void Replay(TQuadBatch* Batch = nullptr);
+		};
+
+		TDrawList CreateDrawList(int Order = 0);
+		TUDrawList CreateUDrawList(int Order = 0);
+
+		/// <summary>
+		/// Returns the global TQSG settings as a draw state
+		/// </summary>
+		TDrawState GrabbedState();
+
+		/// <summary>
+		/// Replays multiple lists sorted on their 'Order' value (lists with the same order keep the order in which they were given). Null entries are skipped.
+		/// All lists share one batch, so image draws with the same texture are sent to SDL together, even across list boundaries.
+		/// Only call this on the thread the graphics screen was created on.
+		/// </summary>
+		void ReplayDrawLists(std::vector<TDrawList>& Lists);
+		void ReplayDrawLists(std::vector<_____TDRAWLIST*>& Lists);
+
+		/*
+		* Render thread
+		* When started, TQSG owns a thread that replays and presents the previous frame, while the game builds the next one.
+		* In this mode draw everything for a frame into FrameList() (or in lists submitted with SubmitToFrame()) and then call Flip().
+		* Flip() will then only wait when the render thread is still busy with the frame before, so the latency is never more than one frame.
+		* While the thread runs, do not use the direct drawing functions outside a draw list. Changing the global settings is fine, as the render thread only uses the settings recorded in the lists.
+		* Loading and disposing images is safe, as TQSG locks the renderer for that.
+		* Please note that not every SDL render driver likes being used outside the thread that created the window (macOS is picky about this).
+		*/
+
+		/// <summary>
+		/// Starts the render thread. A graphics screen must be open.
+		/// </summary>
+		/// <returns>True if succesful</returns>
+		bool StartRenderThread();
+
+		/// <summary>
+		/// Shows the last frame still pending and stops the render thread. (CloseGraphics will call this automatically).
+		/// </summary>
+		void StopRenderThread();
+
+		bool RenderThreaded();
+
+		/// <summary>
+		/// The draw list for the frame currently being built. After Flip() this will be a different (empty) list, so don't keep the pointer.
+		/// </summary>
+		_____TDRAWLIST* FrameList();
+
+		/// <summary>
+		/// Adds a list (for example filled by a worker thread) to the frame currently being built. All lists of the frame are replayed sorted on their Order. FrameList() has order 0 and goes first when orders are equal.
+		/// </summary>
+		void SubmitToFrame(TDrawList List);
+	}
+}
@@ -0,0 +1,128 @@
+// License:
+// 	TQSL/Headers/TQSG_Particles.hpp
+// 	Tricky's Quick SDL2 Graphics - Particles (header)
+// 	version: 26.10.19
+//
+// 	Copyright (C) 2026 Jeroen P. Broks
+//
+// 	This software is provided 'as-is', without any express or implied
+// 	warranty.  In no event will the authors be held liable for any damages
+// 	arising from the use of this software.
+//
+// 	Permission is granted to anyone to use this software for any purpose,
+// 	including commercial applications, and to alter it and redistribute it
+// 	freely, subject to the following restrictions:
+//
+// 	1. The origin of this software must not be misrepresented; you must not
+// 	   claim that you wrote the original software. If you use this software
+// 	   in a product, an acknowledgment in the product documentation would be
+// 	   appreciated but is not required.
+// 	2. Altered source versions must be plainly marked as such, and must not be
+// 	   misrepresented as being the original software.
+// 	3. This notice may not be removed or altered from any source distribution.
+// End License
+
+#pragma once
+#include <random>
+#include "TQSG.hpp"
+
+namespace Slyvina {
+	namespace TQSG {
+
+		/*
+		* Every particle property is kept in its own array (structure of arrays), so the update loops
+		* are simple enough for the compiler to vectorize them. Large emitters can spread the update over
+		* multiple threads. Drawing an emitter is one single geometry batch, no matter how many particles.
+		*/
+
+		class _____TPARTICLEEMITTER; // NEVER USE THIS TYPE DIRECTLY! ONLY USE 'TParticleEmitter' or 'TUParticleEmitter' in stead!
+		typedef std::shared_ptr<_____TPARTICLEEMITTER> TParticleEmitter;
+		typedef std::unique_ptr<_____TPARTICLEEMITTER> TUParticleEmitter;
+
+		class _____TPARTICLEEMITTER {
+		private:
+			TImage _Img{ nullptr };
+			int _Frame{ 0 };
+			size_t
+				_Count{ 0 },
+				_Max{ 0 };
+			std::vector<float>
+				_X{},
+				_Y{},
+				_VX{},
+				_VY{},
+				_Life{},
+				_MaxLife{},
+				_Scale{},
+				_ScaleSpeed{},
+				_Rot{},
+				_RotSpeed{};
+			std::vector<byte>
+				_R{},
+				_G{},
+				_B{},
+				_A{};
+			std::mt19937 _Rnd{ 1 };
+			TQuadBatch _Batch{};
+			void Move(size_t start, size_t end, float dt);
+		public:
+			float
+				GravityX{ 0 },
+				GravityY{ 0 },
+				Drag{ 0 }; // Part of the speed lost per second (0 = none, 1 = all)
+			Blend
+				PBlend{ Blend::ADDITIVE };
+			bool
+				FadeOut{ true }; // When true, alpha goes down towards 0 as the particles get older
+
+			/// <summary>
+			/// When the number of living particles is at least this, Update() will spread the work over multiple threads. 0 means never.
+			/// </summary>
+			size_t ThreadThreshold{ 20000 };
+
+			/// <summary>
+			/// Number of parts big updates are split in, which are then done by TQSG's worker threads (see ParallelRun()). 0 means the number of CPU cores.
+			/// </summary>
+			int Threads{ 0 };
+
+			_____TPARTICLEEMITTER(TImage Img, size_t Max, int frame = 0);
+
+			inline size_t Count() { return _Count; }
+			inline size_t Max() { return _Max; }
+
+			/// <summary>
+			/// Changes the maximum number of particles. Living particles beyond the new maximum are removed.
+			/// </summary>
+			void Resize(size_t Max);
+
+			/// <summary>
+			/// Adds one particle. When the emitter is full, nothing happens and false is returned.
+			/// </summary>
+			/// <param name="life">Life time in seconds</param>
+			/// <param name="rotspeed">Degrees per second</param>
+			bool Emit(float x, float y, float vx, float vy, float life, float scale = 1, float rot = 0, float rotspeed = 0, byte r = 255, byte g = 255, byte b = 255, byte a = 255, float scalespeed = 0);
+
+			/// <summary>
+			/// Adds a number of particles in random directions
+			/// </summary>
+			/// <returns>Number of particles actually added</returns>
+			size_t Burst(size_t num, float x, float y, float minspeed, float maxspeed, float minlife, float maxlife, float scale = 1, byte r = 255, byte g = 255, byte b = 255, byte a = 255);
+
+			/// <summary>
+			/// Moves all particles and removes the ones that died.
+			/// </summary>
+			/// <param name="dt">Time passed in seconds</param>
+			void Update(float dt);
+
+			/// <summary>
+			/// Draws all particles in one batch. The global origin and alt screen settings are taken into account, the global colour, scale and rotation are not, as every particle has its own.
+			/// </summary>
+			void Draw(int offsetx = 0, int offsety = 0);
+
+			inline void Clear() { _Count = 0; }
+		};
+
+		TParticleEmitter CreateParticleEmitter(TImage Img, size_t Max, int frame = 0);
+		TUParticleEmitter CreateUParticleEmitter(TImage Img, size_t Max, int frame = 0);
+	}
+}
@@ -0,0 +1,165 @@
+// License:
+// 	TQSL/Headers/TQSG_Scene.hpp
+// 	Tricky's Quick SDL2 Graphics - Scene (header)
+// 	version: 26.10.19
+//
+// 	Copyright (C) 2026 Jeroen P. Broks
+//
+// 	This software is provided 'as-is', without any express or implied
+// 	warranty.  In no event will the authors be held liable for any damages
+// 	arising from the use of this software.
+//
+// 	Permission is granted to anyone to use this software for any purpose,
+// 	including commercial applications, and to alter it and redistribute it
+// 	freely, subject to the following restrictions:
+//
+// 	1. The origin of this software must not be misrepresented; you must not
+// 	   claim that you wrote the original software. If you use this software
+// 	   in a product, an acknowledgment in the product documentation would be
+// 	   appreciated but is not required.
+// 	2. Altered source versions must be plainly marked as such, and must not be
+// 	   misrepresented as being the original software.
+// 	3. This notice may not be removed or altered from any source distribution.
+// End License
+
+#pragma once
+#include <unordered_map>
+#include "TQSG.hpp"
+
+namespace Slyvina {
+	namespace TQSG {
+
+		/*
+		* A scene keeps sprites (nodes) in stead of drawing them right away.
+		* All nodes are indexed in a uniform grid, so drawing only has to look at the cells the camera can see,
+		* no matter how big the world is. The same grid is used to find out which nodes are at a certain spot (handy for mouse picking).
+		* Nodes are only changed through the scene, as the scene must know when a node moves to other grid cells.
+		*/
+
+		class _____TSCENE; // NEVER USE THIS TYPE DIRECTLY! ONLY USE 'TScene' or 'TUScene' in stead!
+		typedef std::shared_ptr<_____TSCENE> TScene;
+		typedef std::unique_ptr<_____TSCENE> TUScene;
+
+		/// <summary>
+		/// Identifies a node within its scene. 0 means 'no node'. When a node is removed its ID can be given to a new node later.
+		/// </summary>
+		typedef uint32 TSceneID;
+
+		struct TSceneNode {
+			TImage Img{ nullptr };
+			int Frame{ 0 };
+			float
+				X{ 0 },
+				Y{ 0 },
+				ScaleX{ 1 },
+				ScaleY{ 1 },
+				Rotation{ 0 }; // Degrees, around the hotspot
+			byte
+				R{ 255 },
+				G{ 255 },
+				B{ 255 },
+				A{ 255 };
+			Blend NBlend{ Blend::ALPHA };
+			int Z{ 0 }; // Nodes with a higher Z are drawn later (so on top)
+			bool Visible{ true };
+		};
+
+		class _____TSCENE {
+		private:
+			struct __Node {
+				TSceneNode N{};
+				bool Used{ false };
+				SDL_FRect Bounds{ 0,0,0,0 }; // Bounding box in world coordinates, rotation included
+				int cx1{ 0 }, cy1{ 0 }, cx2{ -1 }, cy2{ -1 }; // Grid cells this node is registered in
+				uint32 Stamp{ 0 };
+				uint64 Added{ 0 }; // Goes up with every node added, as IDs are reused
+			};
+			struct __DrawOrder {
+				int Z;
+				SDL_Texture* Tex;
+				Blend NBlend;
+				uint64 Added;
+				TSceneID id;
+				bool operator<(const __DrawOrder& o) const;
+			};
+			int _CellSize{ 256 };
+			std::vector<__Node> _Nodes{};
+			std::vector<TSceneID> _Free{};
+			std::unordered_map<int64, std::vector<TSceneID>> _Grid{};
+			std::vector<TSceneID> _Found{};
+			uint32 _QueryStamp{ 0 };
+			uint64 _Added{ 0 };
+			size_t _Count{ 0 };
+			TQuadBatch _Batch{};
+			__Node* Get(TSceneID id);
+			void Unregister(TSceneID id, __Node& N);
+			void Register(TSceneID id, __Node& N);
+			void Relocate(TSceneID id);
+			bool DrawOrder(TSceneID id, __DrawOrder& O);
+		public:
+			/// <param name="CellSize">Size of a grid cell in world units. Something like twice the size of a typical sprite works best.</param>
+			_____TSCENE(int CellSize = 256);
+
+			/// <summary>
+			/// Adds a node. The hotspot of the image is placed on (x,y).
+			/// </summary>
+			/// <returns>ID of the new node</returns>
+			TSceneID Add(TImage Img, float x, float y, int frame = 0, int z = 0);
+
+			/// <summary>
+			/// Adds a node with all settings taken from Node
+			/// </summary>
+			TSceneID Add(const TSceneNode& Node);
+
+			void Remove(TSceneID id);
+			bool Exists(TSceneID id);
+			void Clear();
+			inline size_t Count() { return _Count; }
+
+			/// <summary>
+			/// Read access to a node. Use the Set... methods of the scene to change it. For an ID not in use an empty node is returned (and the Set... methods just ignore such IDs).
+			/// </summary>
+			const TSceneNode& Node(TSceneID id);
+
+			void Move(TSceneID id, float x, float y);
+			void SetImage(TSceneID id, TImage Img, int frame = 0);
+			void SetFrame(TSceneID id, int frame);
+			void SetScale(TSceneID id, float sx, float sy);
+			inline void SetScale(TSceneID id, float s) { SetScale(id, s, s); }
+			void SetRotation(TSceneID id, float degrees);
+			void SetColor(TSceneID id, byte r, byte g, byte b, byte a = 255);
+			void SetBlend(TSceneID id, Blend _blend);
+			void SetZ(TSceneID id, int z);
+			void SetVisible(TSceneID id, bool visible);
+
+			/// <summary>
+			/// Finds all visible nodes of which the bounding box overlaps the given area (world coordinates).
+			/// </summary>
+			/// <returns>Number of nodes found</returns>
+			size_t Query(float x, float y, float w, float h, std::vector<TSceneID>& Result);
+
+			/// <summary>
+			/// Finds all visible nodes covering the given world coordinate. Rotation is taken into account exactly. The node drawn on top comes first (in the order Draw() uses).
+			/// </summary>
+			size_t Pick(float x, float y, std::vector<TSceneID>& Result);
+
+			/// <summary>
+			/// Returns the node drawn on top at the given world coordinate, or 0 when there's nothing there.
+			/// When picking with the mouse, add the camera position to TQSE::MouseX() and TQSE::MouseY() (and mind the alt screen settings if you use them).
+			/// </summary>
+			TSceneID Pick(float x, float y);
+
+			/// <summary>
+			/// Draws all nodes the camera can see. Nodes are sorted on Z, and within the same Z on texture, so as many as possible go to SDL in one batch.
+			/// Nodes with the same Z, texture and blend are drawn in the order they were added. The global origin and alt screen settings are taken into account, the global colour, scale and rotation are not, as every node has its own.
+			/// </summary>
+			/// <param name="camx">World coordinate shown at the left side of the screen</param>
+			/// <param name="camy">World coordinate shown at the top of the screen</param>
+			/// <returns>Number of nodes drawn</returns>
+			size_t Draw(float camx = 0, float camy = 0);
+		};
+
+		TScene CreateScene(int CellSize = 256);
+		TUScene CreateUScene(int CellSize = 256);
+	}
+}
@@ -20,7 +20,17 @@
 
 #undef TQSA_DEBUG
 
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <map>
+#include <tuple>
+
 #include <TQSA.hpp>
+#include <SlyvString.hpp>
 
 #ifdef TQSA_DEBUG
 #define Chat(abc) std::cout << "\x1b[33mTQSA DEBUG>\t\x1b[0m"<<abc<<"\n"
@@ -34,12 +44,166 @@ namespace Slyvina {
 
 		std::string AudioError() { return _LastError; }
 
+		static TMusic _CurrentMusic{ nullptr };
+
+		// Cross fades. The new music can only start once the old one has faded out. SDL_mixer tells when that happened, and then the fader thread starts the new one.
+		// Playing or stopping music in the mean time just cancels that, so nothing ever waits for a fade.
+		static std::thread _FadeThread;
+		static std::mutex _FadeMutex; // Always taken before SDL_mixer locks the audio, never while it's locked
+		static std::condition_variable _FadeCV;
+		static std::atomic<bool> _MusicFinished{ false };
+		static TMusic
+			_FadeNext{ nullptr },
+			_FadeOld{ nullptr }; // Held while fading out, as freeing it would stop it right away
+		static int
+			_FadeLoops{ -1 },
+			_FadeInMS{ 0 };
+		static bool _FadeStop{ false };
+
+		// SDL_mixer calls this with the audio locked (often from the audio thread), so no locking and no Mix_ functions in here
+		static void MusicFinished() {
+			_MusicFinished = true;
+			_FadeCV.notify_all();
+		}
+
+		static void Fader() {
+			std::unique_lock<std::mutex> L(_FadeMutex);
+			while (true) {
+				// Not only relying on the hook while waiting, as it can't lock, so its wake up could come in just before this waits
+				if (_FadeNext || _FadeOld) _FadeCV.wait_for(L, std::chrono::milliseconds(20)); else _FadeCV.wait(L);
+				if (_FadeStop) return;
+				_MusicFinished = false;
+				if ((!_FadeNext && !_FadeOld) || Mix_PlayingMusic()) continue;
+				_FadeOld = nullptr;
+				if (_FadeNext) {
+					Mix_FadeInMusic(_FadeNext->GetMusic(), _FadeLoops, _FadeInMS);
+					_FadeNext = nullptr;
+				}
+			}
+		}
+
+		// Only call with _FadeMutex locked
+		static void NeedFader() {
+			if (_FadeThread.joinable()) return;
+			_FadeStop = false;
+			Mix_HookMusicFinished(MusicFinished);
+			_FadeThread = std::thread(Fader);
+		}
+
+		static void EndFader() {
+			{
+				std::lock_guard<std::mutex> L(_FadeMutex);
+				_FadeStop = true;
+			}
+			_FadeCV.notify_all();
+			if (!_FadeThread.joinable()) return;
+			_FadeThread.join();
+			Mix_HookMusicFinished(NULL);
+			_FadeNext = nullptr;
+			_FadeOld = nullptr;
+		}
+
+		static std::atomic<bool> _AudioCacheGrown{ false }; // Set by the workers. The cache itself is only touched by the main thread, so it's trimmed there the next time it's used.
+
+		class __AudioLoader {
+		public:
+			struct Job {
+				TAudio Audio; // Held, so the sound can't be gone when the worker gets to it
+				std::shared_ptr<void> Data; // JCR6 entry already read by the caller, as JCR6 may only be used from one thread. Null for files.
+				const void* Mem;
+				int Size;
+				std::string Entry;
+			};
+			static std::deque<Job> Jobs;
+			static std::vector<std::thread> Workers;
+			static std::mutex JobMutex, AudioMutex;
+			static std::condition_variable JobCV, DoneCV;
+			static size_t Busy;
+			static bool Stop;
+			static AudioNotReady Policy;
+
+			static void Load(Job& J) {
+				Mix_Chunk* C{ nullptr };
+				if (J.Data) {
+					auto RW{ SDL_RWFromConstMem(J.Mem, J.Size) };
+					if (RW) C = Mix_LoadWAV_RW(RW, 1); // Decodes and converts to the mixer format
+				} else C = Mix_LoadWAV(J.Entry.c_str());
+				std::string Error{ C ? "" : "Loading \"" + J.Entry + "\" failed: " + Mix_GetError() };
+				std::lock_guard<std::mutex> L(AudioMutex);
+				auto& A{ *J.Audio };
+				if (C) _AudioCacheGrown = true;
+				A.ActualChunk = C;
+				A._LoadError = Error;
+				A._Loading = false;
+				if (C && A._DeferChannel != -2) Mix_PlayChannel(A._DeferChannel, C, A._DeferLoops);
+				A._DeferChannel = -2;
+			}
+
+			static void Worker() {
+				while (true) {
+					std::unique_lock<std::mutex> L(JobMutex);
+					JobCV.wait(L, [] { return Stop || Jobs.size(); });
+					if (Stop) break;
+					auto J{ Jobs.front() };
+					Jobs.pop_front();
+					Busy++;
+					L.unlock();
+					Load(J);
+					L.lock();
+					Busy--;
+					L.unlock();
+					DoneCV.notify_all();
+				}
+			}
+
+			// The empty constructor is private, so only the loader can make a sound that isn't loaded yet
+			static TAudio Empty() { return TAudio(new _____TAudio()); }
+
+			static void Queue(Job J) {
+				{
+					std::lock_guard<std::mutex> L(JobMutex);
+					if (!Workers.size()) for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); i++) Workers.push_back(std::thread(Worker));
+					J.Audio->_Loading = true;
+					Jobs.push_back(J);
+				}
+				JobCV.notify_one();
+			}
+
+			static void End() {
+				{
+					std::lock_guard<std::mutex> L(JobMutex);
+					Stop = true;
+					for (auto& J : Jobs) J.Audio->_Loading = false; // Never going to happen now
+					Jobs.clear();
+				}
+				JobCV.notify_all();
+				for (auto& W : Workers) if (W.joinable()) W.join();
+				Workers.clear();
+				Stop = false;
+				DoneCV.notify_all();
+			}
+		};
+		std::deque<__AudioLoader::Job> __AudioLoader::Jobs{};
+		std::vector<std::thread> __AudioLoader::Workers{};
+		std::mutex
+			__AudioLoader::JobMutex,
+			__AudioLoader::AudioMutex;
+		std::condition_variable
+			__AudioLoader::JobCV,
+			__AudioLoader::DoneCV;
+		size_t __AudioLoader::Busy{ 0 };
+		bool __AudioLoader::Stop{ false };
+		AudioNotReady __AudioLoader::Policy{ AudioNotReady::Skip };
+
 		class ME_Init {
 		public:
 			static std::unique_ptr<ME_Init> MEI;
 			bool Initiated{ true };
 			ME_Init() { Chat("Audio init, detected!"); }
 			~ME_Init() {
+				__AudioLoader::End();
+				EndFader();
+				_CurrentMusic = nullptr;
 				if (Initiated) { Mix_CloseAudio(); Chat("Close audio"); }
 				Initiated = false;
 			}
@@ -62,14 +226,124 @@ namespace Slyvina {
 			return success;
 		}
 
+#pragma region Cache
+		// Key: JCR6 resource (if loaded from a JT_Dir), file, entry (in upper case, as JCR6 doesn't care about case)
+		typedef std::tuple<const void*, std::string, std::string> __AudioKey;
+		static inline __AudioKey AudioKey(std::string File) { return { nullptr, File, "" }; }
+		static inline __AudioKey AudioKey(JCR6::JT_Dir Res, std::string Entry) { return { Res.get(), "", Units::Upper(Entry) }; }
+		static std::map<std::string, JCR6::JT_Dir> _AudioResources{}; // Opened by name, so loading by name shares the cache with AudioResource()
+		class __CachedAudio {
+		public:
+			TAudio Audio{ nullptr };
+			std::weak_ptr<void> Res{}; // To see that a JT_Dir key doesn't point to a new resource on the address of a dead one
+			bool HasRes{ false };
+			uint64 LastUsed{ 0 };
+		};
+		static std::map<__AudioKey, __CachedAudio> _AudioCache{};
+		static bool _AudioCacheEnabled{ true };
+		static size_t _AudioCacheBudget{ 64 * 1024 * 1024 };
+		static uint64 _AudioCacheTick{ 0 };
+
+		static TAudio CacheGet(__AudioKey Key) {
+			if (!_AudioCacheEnabled) return nullptr;
+			if (_AudioCacheGrown.exchange(false)) AudioCacheTrim(); // Before looking, as trimming could throw out what's found
+			auto F{ _AudioCache.find(Key) };
+			if (F == _AudioCache.end()) return nullptr;
+			auto& C{ F->second };
+			if ((C.HasRes && C.Res.expired()) || (!C.Audio->Valid() && !C.Audio->Loading())) {
+				_AudioCache.erase(F); // Stale or failed. Try again.
+				return nullptr;
+			}
+			C.LastUsed = ++_AudioCacheTick;
+			return C.Audio;
+		}
+
+		static TAudio CachePut(__AudioKey Key, TAudio Audio, std::shared_ptr<void> Res = nullptr) {
+			if (!_AudioCacheEnabled || !Audio) return Audio;
+			auto& C{ _AudioCache[Key] };
+			C.Audio = Audio;
+			C.Res = Res;
+			C.HasRes = Res != nullptr;
+			C.LastUsed = ++_AudioCacheTick;
+			AudioCacheTrim();
+			return Audio;
+		}
+
+		size_t _____TAudio::Bytes() {
+			auto C{ ActualChunk.load() };
+			return C ? (size_t)C->alen : 0;
+		}
+
+		bool _____TAudio::Playing() {
+			auto C{ ActualChunk.load() };
+			if (!C) return false;
+			for (int i = 0, n = Mix_AllocateChannels(-1); i < n; i++) if (Mix_Playing(i) && Mix_GetChunk(i) == C) return true;
+			return false;
+		}
+
+		void AudioCache(bool Enabled) {
+			_AudioCacheEnabled = Enabled;
+			if (!Enabled) ClearAudioCache();
+		}
+
+		JCR6::JT_Dir AudioResource(std::string File) {
+			_LastError = "";
+			auto F{ _AudioResources.find(File) };
+			if (F != _AudioResources.end()) return F->second;
+			auto J{ JCR6::JCR6_Dir(File) };
+			if (JCR6::Last()->Error || !J) { _LastError = JCR6::Last()->ErrorMessage; return nullptr; }
+			if (_AudioCacheEnabled) _AudioResources[File] = J;
+			return J;
+		}
+		bool AudioCache() { return _AudioCacheEnabled; }
+
+		void AudioCacheBudget(size_t Bytes) {
+			_AudioCacheBudget = Bytes;
+			AudioCacheTrim();
+		}
+		size_t AudioCacheBudget() { return _AudioCacheBudget; }
+
+		size_t AudioCacheBytes() {
+			size_t ret{ 0 };
+			for (auto& C : _AudioCache) ret += C.second.Audio->Bytes();
+			return ret;
+		}
+		size_t AudioCacheCount() { return _AudioCache.size(); }
+
+		void AudioCacheTrim() {
+			if (!_AudioCacheBudget) return;
+			auto Total{ AudioCacheBytes() };
+			if (Total <= _AudioCacheBudget) return;
+			std::vector<std::map<__AudioKey, __CachedAudio>::iterator> Idle{};
+			for (auto I = _AudioCache.begin(); I != _AudioCache.end(); ++I) {
+				auto& A{ I->second.Audio };
+				// use_count() 1 means only the cache holds it. Sounds still loading have no size yet, so throwing them out gains nothing.
+				if (A.use_count() == 1 && A->Valid() && !A->Playing()) Idle.push_back(I);
+			}
+			std::sort(Idle.begin(), Idle.end(), [](auto& A, auto& B) { return A->second.LastUsed < B->second.LastUsed; });
+			for (auto& I : Idle) {
+				if (Total <= _AudioCacheBudget) break;
+				Total -= I->second.Audio->Bytes();
+				_AudioCache.erase(I);
+			}
+		}
+
+		void ClearAudioCache() {
+			_AudioCache.clear();
+			_AudioResources.clear();
+		}
+#pragma endregion
+
 		TAudio LoadAudio(std::string File) {
 			_LastError = "";
+			auto Key{ AudioKey(File) };
+			if (auto Cached{ CacheGet(Key) }) return Cached;
 			auto TA{ new _____TAudio(File.c_str()) };
 			if (_LastError.size()) {
 				delete TA;
 				return nullptr;
 			}
-			return std::shared_ptr<_____TAudio>(TA);
+			return CachePut(Key, std::shared_ptr<_____TAudio>(TA));
 		}
 
 		TUAudio LoadUAudio(std::string File) {
@@ -84,13 +358,15 @@ namespace Slyvina {
 
 		TAudio LoadAudio(JCR6::JT_Dir JCRResource, std::string Entry) {
 			_LastError = "";
+			auto Key{ AudioKey(JCRResource, Entry) };
+			if (auto Cached{ CacheGet(Key) }) return Cached;
 			if (!JCRResource->EntryExists(Entry)) { _LastError = "JCR6 resource does not have an entry named: " + Entry; }
 			auto TA{ new _____TAudio(JCRResource,Entry) };
 			if (_LastError.size()) {
 				delete TA;
 				return nullptr;
 			}
-			return std::shared_ptr<_____TAudio>(TA);
+			return CachePut(Key, std::shared_ptr<_____TAudio>(TA), JCRResource);
 		}
 
 		TUAudio LoadUAudio(JCR6::JT_Dir JCRResource, std::string Entry) {
@@ -106,15 +382,9 @@ namespace Slyvina {
 		}
 
 		TAudio LoadAudio(std::string JCRResource, std::string Entry) {
-			_LastError = "";
-			auto J = JCR6::JCR6_Dir(JCRResource);
-			if (JCR6::Last()->Error) { _LastError = JCR6::Last()->ErrorMessage; return nullptr; }
-			auto TA{ new _____TAudio(J,Entry) };
-			if (_LastError.size()) {
-				delete TA;
-				return nullptr;
-			}
-			return std::shared_ptr<_____TAudio>(TA);
+			auto J{ AudioResource(JCRResource) }; // The directory is kept, so it's only read once, and the sounds are cached under it
+			if (!J) return nullptr;
+			return LoadAudio(J, Entry);
 		}
 
 		TUAudio LoadUAudio(std::string JCRResource, std::string Entry) {
@@ -164,13 +434,286 @@ namespace Slyvina {
 			return ActualChunk != nullptr;
 		}
 
+		std::string _____TAudio::LoadError() {
+			std::lock_guard<std::mutex> L(__AudioLoader::AudioMutex);
+			return _LoadError;
+		}
+
+		int _____TAudio::NotReady(int channel, int loops) {
+			std::lock_guard<std::mutex> L(__AudioLoader::AudioMutex);
+			if (ActualChunk) return Mix_PlayChannel(channel, ActualChunk, loops); // Just got ready
+			if (_Loading && __AudioLoader::Policy == AudioNotReady::Defer) {
+				_DeferChannel = channel;
+				_DeferLoops = loops;
+			}
+			return -1;
+		}
+
 		int _____TAudio::Play(int loops) {
+			if (!ActualChunk && _Loading) return NotReady(-1, loops);
 			return Mix_PlayChannel(-1, ActualChunk, loops);
 		}
 
 		void _____TAudio::ChPlay(int channel, int loops) {
+			if (!ActualChunk && _Loading) { NotReady(channel, loops); return; }
 			Mix_PlayChannel(channel, ActualChunk, loops);
 		}
 
+		void AudioNotReadyPolicy(AudioNotReady Policy) {
+			std::lock_guard<std::mutex> L(__AudioLoader::AudioMutex);
+			__AudioLoader::Policy = Policy;
+		}
+
+		TAudio LoadAudioAsync(std::string File) {
+			_LastError = "";
+			auto Key{ AudioKey(File) };
+			if (auto Cached{ CacheGet(Key) }) return Cached;
+			if (!ME_Init::MEI) Init_TQSA(); // Here, as the workers need to know the mixer format
+			auto TA{ __AudioLoader::Empty() };
+			__AudioLoader::Queue({ TA, nullptr, nullptr, 0, File });
+			return CachePut(Key, TA);
+		}
+
+		TAudio LoadAudioAsync(JCR6::JT_Dir JCRResource, std::string Entry) {
+			_LastError = "";
+			if (!JCRResource) { _LastError = "LoadAudioAsync(): No JCR6 resource"; return nullptr; }
+			auto Key{ AudioKey(JCRResource, Entry) };
+			if (auto Cached{ CacheGet(Key) }) return Cached;
+			// Reading is done right here, so JCR6 is never used by two threads at once. Only the decoding (which is what takes long) goes to the workers.
+			if (!JCRResource->EntryExists(Entry)) { _LastError = "JCR6 resource does not have an entry named: " + Entry; return nullptr; }
+			auto buf{ JCRResource->B(Entry) };
+			if (!buf || JCR6::Last()->Error) { _LastError = "Loading JCR6 entry failed!\n" + JCR6::Last()->ErrorMessage; return nullptr; }
+			if (!ME_Init::MEI) Init_TQSA();
+			auto TA{ __AudioLoader::Empty() };
+			__AudioLoader::Queue({ TA, buf, buf->Direct(), (int)buf->Size(), Entry });
+			return CachePut(Key, TA, JCRResource);
+		}
+
+		std::vector<TAudio> LoadAudioAsync(JCR6::JT_Dir JCRResource, const std::vector<std::string>& Entries) {
+			std::vector<TAudio> ret{};
+			ret.reserve(Entries.size());
+			for (auto& E : Entries) ret.push_back(LoadAudioAsync(JCRResource, E));
+			return ret;
+		}
+
+		size_t AudioLoading() {
+			std::lock_guard<std::mutex> L(__AudioLoader::JobMutex);
+			return __AudioLoader::Jobs.size() + __AudioLoader::Busy;
+		}
+
+		void AudioWait() {
+			std::unique_lock<std::mutex> L(__AudioLoader::JobMutex);
+			__AudioLoader::DoneCV.wait(L, [] { return __AudioLoader::Jobs.empty() && !__AudioLoader::Busy; });
+			L.unlock();
+			if (_AudioCacheGrown.exchange(false)) AudioCacheTrim();
+		}
+
+
+		TMusic LoadMusic(std::string File) {
+			_LastError = "";
+			auto TM{ new _____TMusic(File.c_str()) };
+			if (_LastError.size()) {
+				delete TM;
+				return nullptr;
+			}
+			return std::shared_ptr<_____TMusic>(TM);
+		}
+
+		TUMusic LoadUMusic(std::string File) {
+			_LastError = "";
+			auto TM{ new _____TMusic(File.c_str()) };
+			if (_LastError.size()) {
+				delete TM;
+				return nullptr;
+			}
+			return std::unique_ptr<_____TMusic>(TM);
+		}
+
+		TMusic LoadMusic(JCR6::JT_Dir JCRResource, std::string Entry) {
+			_LastError = "";
+			auto TM{ new _____TMusic(JCRResource,Entry) };
+			if (_LastError.size()) {
+				delete TM;
+				return nullptr;
+			}
+			return std::shared_ptr<_____TMusic>(TM);
+		}
+
+		TUMusic LoadUMusic(JCR6::JT_Dir JCRResource, std::string Entry) {
+			_LastError = "";
+			auto TM{ new _____TMusic(JCRResource,Entry) };
+			if (_LastError.size()) {
+				delete TM;
+				return nullptr;
+			}
+			return std::unique_ptr<_____TMusic>(TM);
+		}
+
+		TMusic LoadMusic(std::string JCRResource, std::string Entry) {
+			_LastError = "";
+			auto J = JCR6::JCR6_Dir(JCRResource);
+			if (JCR6::Last()->Error) { _LastError = JCR6::Last()->ErrorMessage; return nullptr; }
+			return LoadMusic(J, Entry);
+		}
+
+		TUMusic LoadUMusic(std::string JCRResource, std::string Entry) {
+			_LastError = "";
+			auto J = JCR6::JCR6_Dir(JCRResource);
+			if (JCR6::Last()->Error) { _LastError = JCR6::Last()->ErrorMessage; return nullptr; }
+			return LoadUMusic(J, Entry);
+		}
+
+#pragma region EntryStream
+		// A stored (not packed) JCR6 entry is just a stretch of its main file, so SDL_mixer can read it from there bit by bit while playing.
+		struct __EntryStream {
+			SDL_RWops* File{ nullptr };
+			Sint64
+				Start{ 0 },
+				Size{ 0 },
+				Pos{ 0 };
+		};
+
+		static Sint64 EntryStreamSize(SDL_RWops* RW) { return ((__EntryStream*)RW->hidden.unknown.data1)->Size; }
+
+		static Sint64 EntryStreamSeek(SDL_RWops* RW, Sint64 offset, int whence) {
+			auto ES{ (__EntryStream*)RW->hidden.unknown.data1 };
+			Sint64 P{ 0 };
+			switch (whence) {
+			case RW_SEEK_SET: P = offset; break;
+			case RW_SEEK_CUR: P = ES->Pos + offset; break;
+			case RW_SEEK_END: P = ES->Size + offset; break;
+			default: return SDL_SetError("Unknown seek mode");
+			}
+			if (P < 0 || P > ES->Size) return SDL_SetError("Seek outside of JCR6 entry");
+			if (SDL_RWseek(ES->File, ES->Start + P, RW_SEEK_SET) < 0) return -1;
+			ES->Pos = P;
+			return P;
+		}
+
+		static size_t EntryStreamRead(SDL_RWops* RW, void* ptr, size_t size, size_t maxnum) {
+			auto ES{ (__EntryStream*)RW->hidden.unknown.data1 };
+			if (!size) return 0;
+			maxnum = std::min(maxnum, (size_t)(ES->Size - ES->Pos) / size); // Never past the end of the entry
+			if (!maxnum) return 0;
+			auto Got{ SDL_RWread(ES->File, ptr, 1, maxnum * size) };
+			ES->Pos += Got;
+			return Got / size;
+		}
+
+		static size_t EntryStreamWrite(SDL_RWops*, const void*, size_t, size_t) { SDL_SetError("JCR6 entries are read-only"); return 0; }
+
+		static int EntryStreamClose(SDL_RWops* RW) {
+			auto ES{ (__EntryStream*)RW->hidden.unknown.data1 };
+			auto r{ SDL_RWclose(ES->File) };
+			delete ES;
+			SDL_FreeRW(RW);
+			return r;
+		}
+
+		// Returns nullptr when the entry can't be streamed (packed or in a block), and then it has to be read as a whole.
+		static SDL_RWops* EntryStream(JCR6::JT_Entry E) {
+			if (!E || Units::Upper(E->Storage()) != "STORE" || E->Block()) return nullptr;
+			auto File{ SDL_RWFromFile(E->MainFile.c_str(), "rb") };
+			if (!File) return nullptr;
+			if (SDL_RWseek(File, (Sint64)E->Offset(), RW_SEEK_SET) < 0) { SDL_RWclose(File); return nullptr; }
+			auto RW{ SDL_AllocRW() };
+			if (!RW) { SDL_RWclose(File); return nullptr; }
+			auto ES{ new __EntryStream() };
+			ES->File = File;
+			ES->Start = (Sint64)E->Offset();
+			ES->Size = (Sint64)E->RealSize();
+			RW->size = EntryStreamSize;
+			RW->seek = EntryStreamSeek;
+			RW->read = EntryStreamRead;
+			RW->write = EntryStreamWrite;
+			RW->close = EntryStreamClose;
+			RW->type = SDL_RWOPS_UNKNOWN;
+			RW->hidden.unknown.data1 = ES;
+			return RW;
+		}
+#pragma endregion
+
+		_____TMusic::_____TMusic(const char* File) {
+			if (!ME_Init::MEI) Init_TQSA();
+			ActualMusic = Mix_LoadMUS(File);
+			if (!ActualMusic) _LastError = std::string("Loading music from file \"") + File + "\" failed: " + Mix_GetError();
+		}
+
+		_____TMusic::_____TMusic(JCR6::JT_Dir JCRResource, std::string JCREntry) {
+			if (!ME_Init::MEI) Init_TQSA();
+			_LastError = "";
+			if (!JCRResource->EntryExists(JCREntry)) {
+				_LastError = "Loading JCR Entry \"" + JCREntry + "\" not possible as the entry does not exist!\n";
+				return;
+			}
+			auto RW{ EntryStream(JCRResource->Entry(JCREntry)) };
+			if (RW) {
+				ActualMusic = Mix_LoadMUS_RW(RW, 1);
+				if (!ActualMusic) _LastError = "Loading music from JCR6 entry \"" + JCREntry + "\" failed: " + Mix_GetError();
+				return;
+			}
+			// A packed entry can only be unpacked as a whole, so that one is read once and kept (still packed as music, so way smaller than the PCM).
+			auto buf = JCRResource->B(JCREntry);
+			if (!buf) { _LastError = "Loading JCR6 entry failed!\n" + JCR6::Last()->ErrorMessage; return; }
+			ActualMusic = Mix_LoadMUS_RW(SDL_RWFromConstMem(buf->Direct(), (int)buf->Size()), 1);
+			if (!ActualMusic) { _LastError = "Loading music from JCR6 entry \"" + JCREntry + "\" failed: " + Mix_GetError(); return; }
+			Source = buf;
+		}
+
+		_____TMusic::~_____TMusic() {
+			if (ActualMusic) Mix_FreeMusic(ActualMusic); // Stops it first when it's playing
+		}
+
+		bool _____TMusic::Valid() { return ActualMusic != nullptr; }
+
+		bool _____TMusic::Play(int loops, int FadeInMS) {
+			_LastError = "";
+			if (!ActualMusic) { _LastError = "Music not loaded"; return false; }
+			auto r{ FadeInMS > 0 ? Mix_FadeInMusic(ActualMusic, loops, FadeInMS) : Mix_PlayMusic(ActualMusic, loops) };
+			if (r < 0) { _LastError = std::string("Playing music failed: ") + Mix_GetError(); return false; }
+			return true;
+		}
+
+		bool PlayMusic(TMusic Music, int loops, int FadeInMS) {
+			if (!Music) { _LastError = "PlayMusic(): No music"; return false; }
+			std::lock_guard<std::mutex> L(_FadeMutex);
+			_FadeNext = nullptr; // A cross fade still waiting for its turn is cancelled
+			Mix_HaltMusic(); // SDL_mixer would otherwise wait (with our lock held) for a fade out in progress to finish
+			_FadeOld = nullptr;
+			if (!Music->Play(loops, FadeInMS)) return false;
+			_CurrentMusic = Music;
+			return true;
+		}
+
+		bool CrossFade(TMusic Music, int ms, int loops) {
+			_LastError = "";
+			if (!Music || !Music->Valid()) { _LastError = "CrossFade(): No music"; return false; }
+			std::unique_lock<std::mutex> L(_FadeMutex);
+			if (!Mix_PlayingMusic()) {
+				L.unlock();
+				return PlayMusic(Music, loops, ms);
+			}
+			NeedFader();
+			if (!_FadeOld) _FadeOld = _CurrentMusic; // When an earlier cross fade is still going, that one's old music is what's fading out now
+			Mix_FadeOutMusic(ms / 2);
+			_FadeNext = Music;
+			_FadeLoops = loops;
+			_FadeInMS = std::max(1, ms - (ms / 2));
+			_CurrentMusic = Music;
+			L.unlock();
+			_FadeCV.notify_all();
+			return true;
+		}
+
+		void StopMusic(int FadeOutMS) {
+			std::lock_guard<std::mutex> L(_FadeMutex);
+			_FadeNext = nullptr;
+			if (FadeOutMS > 0) Mix_FadeOutMusic(FadeOutMS); else { Mix_HaltMusic(); _FadeOld = nullptr; }
+		}
+
+		bool MusicPlaying() { return Mix_PlayingMusic() != 0; }
+
+		void MusicVolume(int volume) { Mix_VolumeMusic(std::max(0, std::min(MIX_MAX_VOLUME, volume))); }
+
 	}
 }
\ No newline at end of file
@@ -22,6 +22,13 @@
 // 	3. This notice may not be removed or altered from any source distribution.
 // End License
 
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
 #include <TQSE.hpp>
 #include <SlyvString.hpp>
 
@@ -31,14 +38,58 @@ namespace Slyvina {
 		static std::string TQSE_AppTitle = "Slyvina - TQSE Application";
 
 		static const int maxmousebuttons = 16;
+		static_assert(sizeof(TInputSnapshot::ButDown) == maxmousebuttons, "Snapshot must hold all mouse buttons");
 
 		static bool TQSE_InitDone = false;
 
 		static bool stAppTerminate = false;
 
-		static std::map<int, bool> stKeyDown;
-		static std::map<int, bool> stKeyHit;
-		static std::map<int, bool> stKeyOldDown;		
+		// Until the events say otherwise, the window is assumed to be there and have the focus
+		static bool
+			stWinHidden{ false },
+			stWinMinimized{ false },
+			stWinFocused{ true };
+
+		// Key states are kept as bits indexed by scancode, so cleaning up and finding edges is just a few words of bit operations.
+		class __KeyBits {
+		public:
+			static const int Words{ SDL_NUM_SCANCODES / 64 };
+			uint64 w[Words]{};
+			inline bool Get(int i) const { return i >= 0 && i < SDL_NUM_SCANCODES && ((w[i >> 6] >> (i & 63)) & 1); }
+			inline void Set(int i, bool v) {
+				if (i < 0 || i >= SDL_NUM_SCANCODES) return;
+				if (v) w[i >> 6] |= (uint64)1 << (i & 63); else w[i >> 6] &= ~((uint64)1 << (i & 63));
+			}
+			inline void Clear() { for (auto& W : w) W = 0; }
+		};
+
+		static __KeyBits
+			stKeyDown,
+			stKeyOldDown,
+			stKeyHit,
+			stKeyPressed; // Went down during this Poll(), even if it went up again before the Poll() was done
+
+		// Keycodes of character keys depend on the keyboard layout, so those are looked up in SDL's keymap. All other keycodes are just the scancode with a flag.
+		static SDL_Scancode stCharScan[128];
+		static bool stCharScanValid{ false };
+
+		static void MapCharKeys() {
+			for (int i = 0; i < 128; i++) stCharScan[i] = SDL_GetScancodeFromKey((SDL_Keycode)i);
+			stCharScanValid = true;
+		}
+
+		static int KeyScan(SDL_Keycode c) {
+			if (c & SDLK_SCANCODE_MASK) return c & ~SDLK_SCANCODE_MASK;
+			if (c >= 0 && c < 128) {
+				if (!stCharScanValid) MapCharKeys();
+				return stCharScan[c];
+			}
+			return SDL_GetScancodeFromKey(c); // Letters outside ASCII (like 'é' on some layouts) are rare enough to ask SDL
+		}
+
+		static int
+			MsX{ 0 },
+			MsY{ 0 };
 
 		static bool MsButDown[maxmousebuttons];
 		static bool MsButOldDown[maxmousebuttons];
@@ -324,17 +375,271 @@ namespace Slyvina {
 		}
 
 		static void KeyClean(bool full = false) {
-			//for (auto& i : stAllKeys) {
-			for (unsigned int j = 0; j < numkeys; j++) {
-				auto i = stAllKeys[j];
-				if (full) {
-					stKeyDown[i] = false;
-					stKeyOldDown[i] = false;
-				} else stKeyOldDown[i] = stKeyDown[i];
-				stKeyHit[i] = false;
+			if (full) {
+				stKeyDown.Clear();
+				stKeyOldDown.Clear();
+			} else stKeyOldDown = stKeyDown;
+			stKeyHit.Clear();
+			stKeyPressed.Clear();
+		}
+
+		static void KeyEdges() {
+			// Hit is what's down now and wasn't last time, plus what went down and up again within the same Poll()
+			for (int i = 0; i < __KeyBits::Words; i++) {
+				auto
+					Now{ stKeyDown.w[i] },
+					Old{ stKeyOldDown.w[i] };
+				stKeyHit.w[i] = ((Now ^ Old) & Now) | (stKeyPressed.w[i] & ~Old & ~Now);
+			}
+		}
+
+		static std::vector<TInputEvent> stInputEvents{};
+
+		static std::unordered_map<Uint32, EventFunction> stTypeCallBacks{};
+
+		static char stFrameText[sizeof(TInputSnapshot::Text)]{};
+		static size_t stFrameTextLen{ 0 };
+
+		// Snapshots are published in a ring. Every slot has a sequence number which is odd while the slot is being written and 2*frame+2 when it holds that frame.
+		// A reader copies the slot and checks the sequence number didn't change meanwhile, so neither side ever waits for the other.
+		static const uint64 SnapshotRing{ 16 };
+		struct __SnapshotSlot {
+			std::atomic<uint64> Seq{ 0 };
+			TInputSnapshot Snap{};
+		};
+		static __SnapshotSlot stSnapshots[SnapshotRing]{};
+		static std::atomic<uint64> stSnapshotFrame{ 0 };
+
+		static void PublishSnapshot() {
+			auto Frame{ stSnapshotFrame.load(std::memory_order_relaxed) + 1 };
+			auto& Slot{ stSnapshots[Frame % SnapshotRing] };
+			Slot.Seq.store((2 * Frame) + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			auto& S{ Slot.Snap };
+			S.Frame = Frame;
+			S.Ticks = SDL_GetTicks();
+			memcpy(S.KeyDownBits, stKeyDown.w, sizeof(S.KeyDownBits));
+			memcpy(S.KeyHitBits, stKeyHit.w, sizeof(S.KeyHitBits));
+			memcpy(S.ButDown, MsButDown, sizeof(S.ButDown));
+			memcpy(S.ButHit, MsButHit, sizeof(S.ButHit));
+			memcpy(S.ButReleased, MsMouseReleased, sizeof(S.ButReleased));
+			S.MouseX = MsX;
+			S.MouseY = MsY;
+			S.WheelY = wheelused ? wheel.y : 0;
+			S.AppTerminate = stAppTerminate;
+			memcpy(S.Text, stFrameText, sizeof(S.Text));
+			Slot.Seq.store((2 * Frame) + 2, std::memory_order_release);
+			stSnapshotFrame.store(Frame, std::memory_order_release);
+		}
+		static bool stCoalesceMotion{ true };
+		static EventFilterFunction stEventFilter{ nullptr };
+
+		// Latency measuring. Poll() collects the timestamps of the input, Flip() hands them over with the frame and once that frame is presented, they become samples.
+		static const size_t MaxLatencySamples{ 4096 };
+		static std::atomic<bool> stLatency{ false };
+		static std::mutex stLatencyMutex;
+		static std::vector<Uint32> stLatencyPending{};
+		static std::vector<std::pair<uint64, Uint32>> stLatencySubmitted{}; // Frame, timestamp
+		static uint64
+			stLatencyFrame{ 0 },
+			stLatencyShown{ 0 };
+		static std::vector<Uint32> stLatencySamples{};
+		static size_t stLatencyNext{ 0 };
+
+		static void QueueInput(const SDL_Event& e) {
+			TInputEvent IE{ e.type, e.common.timestamp, 0, 0, 0, false };
+			switch (e.type) {
+			case SDL_KEYDOWN:
+			case SDL_KEYUP:
+				IE.Code = e.key.keysym.scancode;
+				IE.Repeat = e.key.repeat != 0;
+				break;
+			case SDL_MOUSEMOTION:
+				IE.X = e.motion.x;
+				IE.Y = e.motion.y;
+				break;
+			case SDL_MOUSEBUTTONDOWN:
+			case SDL_MOUSEBUTTONUP:
+				IE.Code = e.button.button;
+				IE.X = e.button.x;
+				IE.Y = e.button.y;
+				break;
+			case SDL_MOUSEWHEEL:
+				IE.X = e.wheel.x;
+				IE.Y = e.wheel.y;
+				break;
+			default:
+				return;
+			}
+			stInputEvents.push_back(IE);
+		}
+
+		static void Consume(SDL_Event& e, EventFunction EventCallBack) {
+			QueueInput(e);
+			switch (e.type) {
+			case SDL_KEYDOWN: {
+				auto pkey = e.key.keysym.scancode;
+				//std::cout << "KeyDown:" << (int)pkey << "\n"; // debug only
+				stKeyDown.Set(pkey, true);
+				stKeyPressed.Set(pkey, true);
+				if (e.key.keysym.sym >= 0 && e.key.keysym.sym < 128 && stCharScanValid) stCharScan[e.key.keysym.sym] = pkey;
+				//printf("DOWN: %d\n",pkey);
+				break;
+			}
+			case SDL_KEYUP: {
+				auto pkey = e.key.keysym.scancode;
+				//printf("UP:   %d\n", pkey);
+				stKeyDown.Set(pkey, false);
+				break;
+			}
+			case SDL_KEYMAPCHANGED:
+				stCharScanValid = false;
+				break;
+			case SDL_MOUSEMOTION:
+				MsX = e.motion.x;
+				MsY = e.motion.y;
+				break;
+			case SDL_MOUSEBUTTONDOWN: {
+				auto pbut = e.button.button;
+				if (pbut >= maxmousebuttons) break;
+				MsButDown[pbut] = true;
+				MsButHit[pbut] = MsButDown[pbut] && (!MsButOldDown[pbut]);
+				break;
+			}
+			case SDL_MOUSEBUTTONUP: {
+				auto pbut = e.button.button;
+				if (pbut >= maxmousebuttons) break;
+				MsButDown[pbut] = false;
+				MsMouseReleased[pbut] = true;
+				break;
+			}
+			case SDL_MOUSEWHEEL: {
+				wheel = e.wheel;
+				wheelused = true;
+				break;
+			}
+			case SDL_TEXTINPUT: {
+				auto len{ strnlen(e.text.text, sizeof(e.text.text)) };
+				if (stFrameTextLen + len >= sizeof(stFrameText)) break; // Nobody types that fast. Pasting that much this way is not supported.
+				memcpy(stFrameText + stFrameTextLen, e.text.text, len);
+				stFrameTextLen += len;
+				stFrameText[stFrameTextLen] = 0;
+				break;
+			}
+
+			case SDL_WINDOWEVENT:
+				switch (e.window.event) {
+				case SDL_WINDOWEVENT_SHOWN: stWinHidden = false; break;
+				case SDL_WINDOWEVENT_HIDDEN: stWinHidden = true; break;
+				case SDL_WINDOWEVENT_MINIMIZED: stWinMinimized = true; break;
+				case SDL_WINDOWEVENT_MAXIMIZED:
+				case SDL_WINDOWEVENT_RESTORED:
+					stWinMinimized = false;
+					break;
+				case SDL_WINDOWEVENT_FOCUS_GAINED: stWinFocused = true; break;
+				case SDL_WINDOWEVENT_FOCUS_LOST: stWinFocused = false; break;
+				}
+				break;
+			case SDL_QUIT:
+				stAppTerminate = true;
+				break;
+			}
+			if (EventCallBack) EventCallBack(&e);
+			if (stTypeCallBacks.size()) {
+				auto CB{ stTypeCallBacks.find(e.type) };
+				if (CB != stTypeCallBacks.end()) CB->second(&e);
+			}
+		}
+
+		// Input log. Native byte order, so only meant to be replayed on the same kind of machine.
+		// Header: "TQSEINPT", version (uint32), sizeof(SDL_Event) (uint32)
+		// Record: Poll number (uint32), size (uint16), that many bytes of the event (timestamp included). Size 0 marks the end.
+		static const char InputLogMagic[8]{ 'T','Q','S','E','I','N','P','T' };
+		static const uint32 InputLogVersion{ 1 };
+		static std::ofstream stRecord{};
+		static std::vector<byte> stReplay{};
+		static size_t stReplayPos{ 0 };
+		static bool
+			stRecording{ false },
+			stReplaying{ false },
+			stReplayTerminate{ true };
+		static uint64 stInputFrame{ 0 };
+		static std::string stInputLogError{ "" };
+
+		static Uint16 EventSize(const SDL_Event& e) {
+			switch (e.type) {
+			case SDL_KEYDOWN:
+			case SDL_KEYUP:
+				return sizeof(SDL_KeyboardEvent);
+			case SDL_TEXTINPUT:
+				return sizeof(SDL_TextInputEvent);
+			case SDL_MOUSEMOTION:
+				return sizeof(SDL_MouseMotionEvent);
+			case SDL_MOUSEBUTTONDOWN:
+			case SDL_MOUSEBUTTONUP:
+				return sizeof(SDL_MouseButtonEvent);
+			case SDL_MOUSEWHEEL:
+				return sizeof(SDL_MouseWheelEvent);
+			case SDL_WINDOWEVENT:
+				return sizeof(SDL_WindowEvent);
+			case SDL_QUIT:
+				return sizeof(SDL_CommonEvent);
+			case SDL_SYSWMEVENT:
+			case SDL_DROPFILE:
+			case SDL_DROPTEXT:
+				return 0; // These carry pointers, which mean nothing in another run
+			default:
+				return e.type >= SDL_USEREVENT ? 0 : sizeof(SDL_Event);
+			}
+		}
+
+		template<class T> static inline void LogWrite(T v) { stRecord.write((const char*)&v, sizeof(T)); }
+
+		template<class T> static inline bool LogRead(T& v) {
+			if (stReplayPos + sizeof(T) > stReplay.size()) return false;
+			memcpy(&v, stReplay.data() + stReplayPos, sizeof(T));
+			stReplayPos += sizeof(T);
+			return true;
+		}
+
+		static void Record(const SDL_Event& e) {
+			auto size{ EventSize(e) };
+			if (!size) return;
+			LogWrite((uint32)stInputFrame);
+			LogWrite(size);
+			stRecord.write((const char*)&e, size);
+		}
+
+		static void Replay(EventFunction EventCallBack) {
+			SDL_Event e;
+			// The real events are not used, but SDL still needs them taken away. Only a real request to quit is honored.
+			while (SDL_PollEvent(&e) != 0) if (e.type == SDL_QUIT) stAppTerminate = true;
+			while (stReplaying) {
+				uint32 frame;
+				Uint16 size;
+				auto pos{ stReplayPos };
+				if (!LogRead(frame)) { stInputLogError = "Input log ended without end mark"; size = 0; }
+				else if (frame > stInputFrame) { stReplayPos = pos; return; }
+				else if (!LogRead(size)) { stInputLogError = "Input log truncated"; size = 0; }
+				if (!size) {
+					stReplaying = false;
+					stReplay.clear();
+					if (stReplayTerminate) stAppTerminate = true;
+					return;
+				}
+				if (stReplayPos + size > stReplay.size()) { stInputLogError = "Input log truncated"; stReplayPos = stReplay.size(); continue; }
+				memset(&e, 0, sizeof(SDL_Event));
+				memcpy(&e, stReplay.data() + stReplayPos, std::min((size_t)size, sizeof(SDL_Event)));
+				stReplayPos += size;
+				Consume(e, EventCallBack);
 			}
 		}
 
+		static inline void Take(SDL_Event& e, EventFunction EventCallBack) {
+			if (stRecording) Record(e);
+			Consume(e, EventCallBack);
+		}
+
 		void Poll(EventFunction EventCallBack) {
 			// All initiated?
 			if (!TQSE_InitDone) {
@@ -347,59 +652,231 @@ namespace Slyvina {
 			MouseClean();
 			stAppTerminate = false;
 			wheelused = false;
-			SDL_Event e;
-			while (SDL_PollEvent(&e) != 0) {
-				switch (e.type) {
-				case SDL_KEYDOWN: {
-					auto pkey = e.key.keysym.sym;
-					//std::cout << "KeyDown:" << (int)pkey << "\n"; // debug only
-					stKeyDown[pkey] = true;
-					stKeyHit[pkey] = stKeyDown[pkey] && (!stKeyOldDown[pkey]);
-					//printf("DOWN: %d\n",pkey);
-					break;
-				}
-				case SDL_KEYUP: {
-					auto pkey = e.key.keysym.sym;
-					//printf("UP:   %d\n", pkey);
-					stKeyDown[pkey] = false;
-					break;
+			stInputEvents.clear();
+			stFrameTextLen = 0;
+			stFrameText[0] = 0;
+			if (stReplaying) Replay(EventCallBack); else {
+				SDL_Event e, Motion;
+				bool HaveMotion{ false };
+				while (SDL_PollEvent(&e) != 0) {
+					if (stCoalesceMotion && e.type == SDL_MOUSEMOTION) {
+						// A fast mouse can send hundreds of these per frame. Only the last position matters, as long as the relative motion adds up.
+						if (HaveMotion && Motion.motion.which == e.motion.which) {
+							e.motion.xrel += Motion.motion.xrel;
+							e.motion.yrel += Motion.motion.yrel;
+						} else if (HaveMotion) Take(Motion, EventCallBack);
+						Motion = e;
+						HaveMotion = true;
+						continue;
+					}
+					if (HaveMotion) { Take(Motion, EventCallBack); HaveMotion = false; } // Keep the order with clicks and such
+					Take(e, EventCallBack);
 				}
-				case SDL_MOUSEBUTTONDOWN: {
-					auto pbut = e.button.button;
-					MsButDown[pbut] = true;
-					MsButHit[pbut] = MsButDown[pbut] && (!MsButOldDown[pbut]);
-					break;
-				}
-				case SDL_MOUSEBUTTONUP: {
-					auto pbut = e.button.button;
-					MsButDown[pbut] = false;
-					MsMouseReleased[pbut] = true;
-					break;
-				}
-				case SDL_MOUSEWHEEL: {
-					wheel = e.wheel;
-					wheelused = true;
-					break;
+				if (HaveMotion) Take(Motion, EventCallBack);
+				SDL_GetMouseState(&MsX, &MsY);
+				if (stLatency && stInputEvents.size()) {
+					// Recorded timestamps mean nothing now, so replays are not measured
+					std::lock_guard<std::mutex> L(stLatencyMutex);
+					for (auto& IE : stInputEvents) if (!IE.Repeat) stLatencyPending.push_back(IE.Timestamp);
 				}
+			}
+			KeyEdges();
+			stInputFrame++;
+			PublishSnapshot();
+		}
 
-				case SDL_QUIT:
-					stAppTerminate = true;
-					break;
+		uint64 LatestInputFrame() { return stSnapshotFrame.load(std::memory_order_acquire); }
+
+		bool GetInputSnapshot(TInputSnapshot& Snap, uint64 Frame) {
+			if (!Frame) return false;
+			auto& Slot{ stSnapshots[Frame % SnapshotRing] };
+			while (true) {
+				auto Before{ Slot.Seq.load(std::memory_order_acquire) };
+				if (Before != (2 * Frame) + 2) {
+					if (Before & 1) continue; // Being written right now. That doesn't take long.
+					return false; // Not there yet, or already replaced by a newer frame
 				}
-				if (EventCallBack) EventCallBack(&e);
+				memcpy((void*)&Snap, (const void*)&Slot.Snap, sizeof(TInputSnapshot));
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (Slot.Seq.load(std::memory_order_relaxed) == Before) return true;
 			}
 		}
 
+		bool GetInputSnapshot(TInputSnapshot& Snap) {
+			// When Poll() is fast enough to go round the whole ring while this copies, just try the newer frame
+			for (auto Frame{ LatestInputFrame() }; Frame; Frame = LatestInputFrame()) if (GetInputSnapshot(Snap, Frame)) return true;
+			return false;
+		}
+
+		bool TInputSnapshot::KeyDown(SDL_Scancode c) const { return c >= 0 && c < SDL_NUM_SCANCODES && ((KeyDownBits[c >> 6] >> (c & 63)) & 1); }
+		bool TInputSnapshot::KeyHit(SDL_Scancode c) const { return c >= 0 && c < SDL_NUM_SCANCODES && ((KeyHitBits[c >> 6] >> (c & 63)) & 1); }
+		bool TInputSnapshot::KeyDown(SDL_KeyCode c) const { return KeyDown(SDL_GetScancodeFromKey(c)); }
+		bool TInputSnapshot::KeyHit(SDL_KeyCode c) const { return KeyHit(SDL_GetScancodeFromKey(c)); }
+		bool TInputSnapshot::MouseDown(int c) const { return c >= 0 && c < maxmousebuttons && ButDown[c]; }
+		bool TInputSnapshot::MouseHit(int c) const { return c >= 0 && c < maxmousebuttons && ButHit[c]; }
+		bool TInputSnapshot::MouseReleased(int c) const { return c >= 0 && c < maxmousebuttons && ButReleased[c]; }
+
+		const std::vector<TInputEvent>& InputEvents() { return stInputEvents; }
+
+		void OnEvent(Uint32 Type, EventFunction CallBack) {
+			if (CallBack) stTypeCallBacks[Type] = CallBack; else stTypeCallBacks.erase(Type);
+		}
+
+		void EventIgnore(Uint32 Type, bool Ignore) { SDL_EventState(Type, Ignore ? SDL_IGNORE : SDL_ENABLE); }
+
+		bool EventIgnored(Uint32 Type) { return SDL_EventState(Type, SDL_QUERY) == SDL_IGNORE; }
+
+		static int SDLCALL FilterTrampoline(void*, SDL_Event* e) {
+			auto F{ stEventFilter };
+			return (!F) || F(e);
+		}
+
+		void EventFilter(EventFilterFunction Filter) {
+			stEventFilter = Filter;
+			if (Filter) SDL_SetEventFilter(FilterTrampoline, NULL); else SDL_SetEventFilter(NULL, NULL);
+		}
+
+		void CoalesceMotion(bool on) { stCoalesceMotion = on; }
+
+		bool CoalesceMotion() { return stCoalesceMotion; }
+
+		int KeyHitCount(SDL_KeyCode c) {
+			int sc{ KeyScan(c) }, ret{ 0 };
+			for (auto& IE : stInputEvents) if (IE.Type == SDL_KEYDOWN && IE.Code == sc && !IE.Repeat) ret++;
+			return ret;
+		}
+
+		void InputLatency(bool on) {
+			std::lock_guard<std::mutex> L(stLatencyMutex);
+			stLatencyPending.clear();
+			stLatencySubmitted.clear();
+			stLatencySamples.clear();
+			stLatencyNext = 0;
+			stLatencyShown = stLatencyFrame;
+			stLatency = on;
+		}
+
+		bool InputLatency() { return stLatency; }
+
+		void InputSubmitted() {
+			if (!stLatency) return;
+			std::lock_guard<std::mutex> L(stLatencyMutex);
+			stLatencyFrame++;
+			for (auto T : stLatencyPending) stLatencySubmitted.push_back({ stLatencyFrame, T });
+			stLatencyPending.clear();
+		}
+
+		void InputPresented() {
+			if (!stLatency) return;
+			auto Now{ SDL_GetTicks() };
+			std::lock_guard<std::mutex> L(stLatencyMutex);
+			if (stLatencyShown >= stLatencyFrame) return; // Presented without InputSubmitted() (or before measuring began)
+			stLatencyShown++;
+			size_t n{ 0 };
+			for (; n < stLatencySubmitted.size() && stLatencySubmitted[n].first <= stLatencyShown; n++) {
+				auto Sample{ Now - stLatencySubmitted[n].second };
+				if (stLatencySamples.size() < MaxLatencySamples) stLatencySamples.push_back(Sample); else stLatencySamples[stLatencyNext] = Sample;
+				stLatencyNext = (stLatencyNext + 1) % MaxLatencySamples;
+			}
+			stLatencySubmitted.erase(stLatencySubmitted.begin(), stLatencySubmitted.begin() + n);
+		}
+
+		size_t InputLatencySamples() {
+			std::lock_guard<std::mutex> L(stLatencyMutex);
+			return stLatencySamples.size();
+		}
+
+		Uint32 InputLatencyPercentile(double p) {
+			std::vector<Uint32> Sorted{};
+			{
+				std::lock_guard<std::mutex> L(stLatencyMutex);
+				Sorted = stLatencySamples;
+			}
+			if (!Sorted.size()) return 0;
+			auto i{ (size_t)(std::min(std::max(p, 0.0), 100.0) / 100.0 * (Sorted.size() - 1) + 0.5) };
+			std::nth_element(Sorted.begin(), Sorted.begin() + i, Sorted.end());
+			return Sorted[i];
+		}
+
+		bool StartInputRecording(std::string File) {
+			StopInputRecording();
+			if (stReplaying) { stInputLogError = "Can't record while replaying"; return false; }
+			stRecord.open(File, std::ios::binary);
+			if (!stRecord) { stInputLogError = "Could not write " + File; return false; }
+			stRecord.write(InputLogMagic, sizeof(InputLogMagic));
+			LogWrite(InputLogVersion);
+			LogWrite((uint32)sizeof(SDL_Event));
+			stInputFrame = 0;
+			stInputLogError = "";
+			stRecording = true;
+			return true;
+		}
+
+		void StopInputRecording() {
+			if (!stRecording) return;
+			LogWrite((uint32)stInputFrame);
+			LogWrite((Uint16)0);
+			stRecord.close();
+			stRecording = false;
+		}
+
+		bool InputRecording() { return stRecording; }
+
+		bool StartInputReplay(std::string File, bool TerminateAtEnd) {
+			StopInputReplay();
+			if (stRecording) { stInputLogError = "Can't replay while recording"; return false; }
+			std::ifstream In{ File, std::ios::binary | std::ios::ate };
+			if (!In) { stInputLogError = "Could not read " + File; return false; }
+			// All of it is loaded right away, so replaying doesn't wait for the disk
+			stReplay.resize((size_t)In.tellg());
+			In.seekg(0);
+			In.read((char*)stReplay.data(), stReplay.size());
+			stReplayPos = 0;
+			char Magic[sizeof(InputLogMagic)];
+			uint32 Version{ 0 }, EvSize{ 0 };
+			for (auto& c : Magic) if (!LogRead(c)) break;
+			if (memcmp(Magic, InputLogMagic, sizeof(InputLogMagic)) || !LogRead(Version) || !LogRead(EvSize)) { stInputLogError = File + " is not an input log"; stReplay.clear(); return false; }
+			if (Version != InputLogVersion || EvSize != sizeof(SDL_Event)) { stInputLogError = File + " was recorded by another version"; stReplay.clear(); return false; }
+			// Start with nothing held, just like when the recording was made
+			KeyClean(true);
+			MouseClean(true);
+			TQSE_InitDone = true;
+			stInputFrame = 0;
+			stInputLogError = "";
+			stReplayTerminate = TerminateAtEnd;
+			stReplaying = true;
+			return true;
+		}
+
+		void StopInputReplay() {
+			stReplaying = false;
+			stReplay.clear();
+		}
+
+		bool InputReplaying() { return stReplaying; }
+
+		uint64 InputFrame() { return stInputFrame; }
+
+		std::string InputLogError() { return stInputLogError; }
+
 		bool AppTerminate() { return stAppTerminate; }
 
-		bool KeyHit(SDL_KeyCode c) { return stKeyHit[c]; }
+		bool WindowMinimized() { return stWinMinimized; }
+		bool WindowHidden() { return stWinHidden; }
+		bool WindowFocused() { return stWinFocused; }
 
-		bool KeyDown(SDL_KeyCode c) { return stKeyDown[c]; }
+		bool KeyHit(SDL_KeyCode c) { return stKeyHit.Get(KeyScan(c)); }
+
+		bool KeyDown(SDL_KeyCode c) { return stKeyDown.Get(KeyScan(c)); }
 
 		int GetMouseButtons() { return maxmousebuttons; }
 
 		SDL_KeyCode GetKey() {
-			for (auto& c : stKeyHit) if (c.second) return (SDL_KeyCode)c.first;
+			for (int i = 0; i < __KeyBits::Words; i++) {
+				auto W{ stKeyHit.w[i] };
+				if (!W) continue;
+				for (int b = 0; b < 64; b++) if ((W >> b) & 1) return (SDL_KeyCode)SDL_GetKeyFromScancode((SDL_Scancode)((i << 6) + b));
+			}
 			return SDLK_UNKNOWN;
 		}
 
@@ -486,17 +963,9 @@ namespace Slyvina {
 
 
 
-		int MouseX() {
-			int x, y;
-			SDL_GetMouseState(&x, &y);
-			return x;
-		}
+		int MouseX() { return MsX; }
 
-		int MouseY() {
-			int x, y;
-			SDL_GetMouseState(&x, &y);
-			return y;
-		}
+		int MouseY() { return MsY; }
 
 		void HideMouse() {
 			SDL_ShowCursor(SDL_DISABLE);
@@ -517,7 +986,8 @@ namespace Slyvina {
 		}
 
 		bool MouseReleased(int c) {
-			return MsMouseReleased[(SDL_KeyCode)c];
+			if (c < 0 || c >= maxmousebuttons) return false;
+			return MsMouseReleased[c];
 		}
 
 		int MouseWheelY() {
@@ -639,14 +1109,16 @@ namespace Slyvina {
 
 
 		void Flush() {
-			while (
-				AppTerminate() ||
-				GetKey() ||
-				MouseHit(1) ||
-				MouseHit(2) ||
-				MouseHit(3)
-				)
-				Poll();
+			// One Poll() takes everything waiting in the queue, so the keys and buttons still held are known. Forgetting what was hit is then all that's left.
+			// (Polling until nothing was hit anymore would spin for as long as a key was held down)
+			Poll();
+			KeyClean();
+			MouseClean();
+			stAppTerminate = false;
+			wheelused = false;
+			stFrameTextLen = 0;
+			stFrameText[0] = 0;
+			PublishSnapshot(); // Or readers on other threads would still see the hits Poll() just published
 		}
 
 		void AppTitle(std::string Title) {
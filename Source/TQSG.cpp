@@ -34,8 +34,22 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TQSG_SSE2
+#endif
 
 #include <TQSG.hpp>
+#include <TQSG_DrawList.hpp>
 #include <SlyvString.hpp>
 #include <SlyvHSVRGB.hpp>
 #include <SlyvStream.hpp>
@@ -73,7 +87,15 @@ namespace Slyvina {
 			_originy{ 0 };
 
 
-		static SDL_BlendMode SDLBlend() { return (SDL_BlendMode)_blend; }
+		// The global settings as a draw state, so the drawing code itself only has to know draw states
+		static TDrawState CurrentState() {
+			TDrawState S;
+			S.r = _red; S.g = _green; S.b = _blue; S.alpha = _alpha;
+			S.blend = _blend;
+			S.scalex = _scalex; S.scaley = _scaley; S.rotatedeg = _rotatedeg;
+			S.originx = _originx; S.originy = _originy;
+			return S;
+		}
 
 
 		class __Screen { // A secret class I will use to make sure SDL stuff is always properly disposed.
@@ -91,12 +113,53 @@ namespace Slyvina {
 		};
 		std::unique_ptr<__Screen> _Screen{ nullptr };
 
+		// Everything talking to the renderer while a render thread may be active should hold this.
+		static std::recursive_mutex _RenderMutex;
+		typedef std::lock_guard<std::recursive_mutex> __RenderLock;
+
+		// Dirty rectangle mode (the rest is in the DirtyRects region)
+		static bool
+			_DirtyMode{ false },
+			_DirtyRedrawing{ false };
+		static SDL_Rect _DirtyCurrent{ 0,0,0,0 };
+		static void DirtyFlip(int minticks);
+		static void ForgetBackBuffer();
+		static void ForgetScene();
+
+		// Canvas targets (the rest is in the Canvas region)
+		static uint64 _GraphicsSession{ 0 }; // Goes up every time a new renderer is created, so canvases know when their texture went down with the old one
+		class __TargetState {
+		public:
+			SDL_Texture* OldTarget{ nullptr };
+			SDL_Rect OldViewport{ 0,0,0,0 };
+			bool OldClipEnabled{ false };
+			SDL_Rect OldClip{ 0,0,0,0 };
+			int
+				AltW{ 0 },
+				AltH{ 0 };
+			size_t ViewDepth{ 0 };
+		};
+		static std::vector<__TargetState> _TargetStack{};
+
+		// GPU alt screen mode (see AltScreenGPU()). The GPU scale is what the renderer is set to right now, the base scale is what the dynamic resolution scene adds to that (1 outside a scene).
+		static std::atomic<bool> _AltGPU{ false }; // Atomic (as are the fields of __AltScreen), since the render thread reads them while replaying
+		static double
+			_GPUScaleX{ 1 },
+			_GPUScaleY{ 1 },
+			_BaseScaleX{ 1 },
+			_BaseScaleY{ 1 };
+		static void ApplyAltScale();
+
+		// Dynamic resolution (the rest is in the DynamicResolution region)
+		static bool _InScene{ false };
+		static void DynamicGovernor();
+
 		class __AltScreen {
 		private:
-			int w{ 0 };
-			int h{ 0 };
-			double ref_x{ 1.0 };
-			double ref_y{ 1.0 };
+			std::atomic<int> w{ 0 };
+			std::atomic<int> h{ 0 };
+			std::atomic<double> ref_x{ 1.0 };
+			std::atomic<double> ref_y{ 1.0 };
 		public:
 			void SetW(int _w) {
 				w = _w;
@@ -104,6 +167,7 @@ namespace Slyvina {
 					ref_x = 1;
 				else
 					ref_x = ((double)ScreenWidth(true)) / ((double)_w);
+				ApplyAltScale();
 			}
 			void SetH(int _h) {
 				h = _h;
@@ -111,20 +175,48 @@ namespace Slyvina {
 					ref_y = 1;
 				else
 					ref_y = ((double)ScreenHeight(true)) / ((double)_h);
+				ApplyAltScale();
 			}
 			int GetW() { return w; }
 			int GetH() { return h; }
-			int X(int x) { if (w <= 0) return x; return (int)floor(x * ref_x); }
-			int Y(int y) { if (h <= 0) return y; return (int)floor(y * ref_y); }
-			int W(int w) { if (w <= 0) return w; return (int)ceil(w * ref_x); }
-			int H(int h) { if (h <= 0) return h; return (int)ceil(h * ref_y); }
+			// In GPU mode the renderer does the scaling, so then these leave everything as it is
+			int X(int x) { if (_AltGPU) return x; return TrueX(x); }
+			int Y(int y) { if (_AltGPU) return y; return TrueY(y); }
+			int W(int w) { if (_AltGPU) return w; return TrueW(w); }
+			int H(int h) { if (_AltGPU) return h; return TrueH(h); }
 			int ScaledW(int w) { return (int)ceil(W(w) * _scalex); }
 			int ScaledH(int h) { return (int)ceil(H(w) * _scalex); }
-			double RX() { return ref_x; }
-			double RY() { return ref_y; }
+			double RX() { return _AltGPU ? 1 : ref_x.load(); }
+			double RY() { return _AltGPU ? 1 : ref_y.load(); }
+			// These always give true screen pixels
+			int TrueX(int x) { if (w <= 0) return x; return (int)floor(x * ref_x); }
+			int TrueY(int y) { if (h <= 0) return y; return (int)floor(y * ref_y); }
+			int TrueW(int w) { if (w <= 0) return w; return (int)ceil(w * ref_x); }
+			int TrueH(int h) { if (h <= 0) return h; return (int)ceil(h * ref_y); }
+			double TrueRX() { return ref_x; }
+			double TrueRY() { return ref_y; }
 		};
 		__AltScreen AltScreen;
 
+		static void ApplyAltScale() {
+			double
+				sx{ _BaseScaleX * (_AltGPU ? AltScreen.TrueRX() : 1) },
+				sy{ _BaseScaleY * (_AltGPU ? AltScreen.TrueRY() : 1) };
+			bool Changed{ sx != _GPUScaleX || sy != _GPUScaleY };
+			_GPUScaleX = sx;
+			_GPUScaleY = sy;
+			if (_Screen && (_AltGPU || Changed)) SDL_RenderSetScale(_Screen->gRenderer, (float)sx, (float)sy);
+		}
+
+		// Functions working in true screen pixels switch the scaling of the GPU alt screen mode off while they work
+		class __TrueCoords {
+		private:
+			bool Active;
+		public:
+			inline __TrueCoords() : Active{ _Screen && (_GPUScaleX != _BaseScaleX || _GPUScaleY != _BaseScaleY) } { if (Active) SDL_RenderSetScale(_Screen->gRenderer, (float)_BaseScaleX, (float)_BaseScaleY); }
+			inline ~__TrueCoords() { if (Active) SDL_RenderSetScale(_Screen->gRenderer, (float)_GPUScaleX, (float)_GPUScaleY); }
+		};
+
 		std::string LastError() { return _LastError; }
 
 
@@ -145,10 +237,137 @@ namespace Slyvina {
 		inline bool NeedScreen() { if (!_Screen) { Paniek("Action requiring a graphics screen"); return false; } else return true; }
 #pragma endregion
 
+#pragma region ViewportAndClip
+		// Both of these only ask SDL what it already knows, so they are cheap. Way cheaper than sending something to SDL that will never be seen.
+		static bool Culled(float x, float y, float w, float h) {
+			if (!_Screen) return false;
+			if (w < 0) { x += w; w = -w; }
+			if (h < 0) { y += h; h = -h; }
+			SDL_Rect VP;
+			SDL_RenderGetViewport(_Screen->gRenderer, &VP);
+			float
+				cx1{ 0 },
+				cy1{ 0 },
+				cx2{ (float)VP.w },
+				cy2{ (float)VP.h };
+			if (SDL_RenderIsClipEnabled(_Screen->gRenderer)) {
+				SDL_Rect C;
+				SDL_RenderGetClipRect(_Screen->gRenderer, &C);
+				cx1 = std::max(cx1, (float)C.x);
+				cy1 = std::max(cy1, (float)C.y);
+				cx2 = std::min(cx2, (float)(C.x + C.w));
+				cy2 = std::min(cy2, (float)(C.y + C.h));
+			}
+			return x >= cx2 || y >= cy2 || x + w <= cx1 || y + h <= cy1;
+		}
+		static inline bool Culled(const SDL_Rect& R) { return Culled((float)R.x, (float)R.y, (float)R.w, (float)R.h); }
+
+		// Same, but for a rect rotated around (cx,cy) (relative to the rect, like SDL_RenderCopyEx does)
+		static bool Culled(float x, float y, float w, float h, double angle, float cx, float cy) {
+			if (!angle) return Culled(x, y, w, h);
+			auto rad{ angle * PI / 180 };
+			float
+				cs{ (float)cos(rad) },
+				sn{ (float)sin(rad) },
+				lx[4]{ -cx, w - cx, w - cx, -cx },
+				ly[4]{ -cy, -cy, h - cy, h - cy },
+				x1{ 0 }, y1{ 0 }, x2{ 0 }, y2{ 0 };
+			for (int i = 0; i < 4; i++) {
+				float
+					px{ (lx[i] * cs) - (ly[i] * sn) },
+					py{ (lx[i] * sn) + (ly[i] * cs) };
+				x1 = i ? std::min(x1, px) : px; x2 = i ? std::max(x2, px) : px;
+				y1 = i ? std::min(y1, py) : py; y2 = i ? std::max(y2, py) : py;
+			}
+			return Culled(x + cx + x1, y + cy + y1, x2 - x1, y2 - y1);
+		}
+
+		class __ViewState {
+		public:
+			bool Viewport{ false };
+			SDL_Rect OldViewport{ 0,0,0,0 };
+			bool OldClipEnabled{ false };
+			SDL_Rect OldClip{ 0,0,0,0 };
+		};
+		static std::vector<__ViewState> _ViewStack{};
+
+		static void PushViewState(bool Viewport) {
+			__ViewState VS;
+			VS.Viewport = Viewport;
+			SDL_RenderGetViewport(_Screen->gRenderer, &VS.OldViewport);
+			VS.OldClipEnabled = SDL_RenderIsClipEnabled(_Screen->gRenderer);
+			SDL_RenderGetClipRect(_Screen->gRenderer, &VS.OldClip);
+			_ViewStack.push_back(VS);
+		}
+
+		static void PopViewState(bool Viewport) {
+			_LastError = "";
+			if (!NeedScreen()) return;
+			if (!_ViewStack.size()) {
+				_LastError = Viewport ? "PopViewport(): Nothing to pop" : "PopClip(): Nothing to pop";
+				return;
+			}
+			auto& VS{ _ViewStack.back() };
+			if (VS.Viewport != Viewport) _LastError = "Viewports and clip rects must be popped in the reverse order they were pushed";
+			SDL_RenderSetViewport(_Screen->gRenderer, &VS.OldViewport);
+			SDL_RenderSetClipRect(_Screen->gRenderer, VS.OldClipEnabled ? &VS.OldClip : NULL);
+			_ViewStack.pop_back();
+		}
+
+		void PushViewport(int x, int y, int w, int h) {
+			_LastError = "";
+			if (!NeedScreen()) return;
+			PushViewState(true);
+			SDL_Rect VP{ AltScreen.X(x), AltScreen.Y(y), AltScreen.W(w), AltScreen.H(h) };
+			SDL_RenderSetViewport(_Screen->gRenderer, &VP);
+			auto& VS{ _ViewStack.back() };
+			if (!VS.OldClipEnabled) { SDL_RenderSetClipRect(_Screen->gRenderer, NULL); return; }
+			// SDL's clip rect is relative to the viewport, so the old one must be moved into the new viewport's coordinates to keep clipping the same area.
+			SDL_Rect
+				C{ VS.OldClip.x + VS.OldViewport.x - VP.x, VS.OldClip.y + VS.OldViewport.y - VP.y, VS.OldClip.w, VS.OldClip.h },
+				Inside{ 0, 0, VP.w, VP.h };
+			if (!SDL_IntersectRect(&C, &Inside, &C)) C = { -2,-2,1,1 }; // Nothing left. Empty would mean 'no clipping' to SDL.
+			SDL_RenderSetClipRect(_Screen->gRenderer, &C);
+		}
+
+		void PopViewport() { PopViewState(true); }
+
+		void PushClip(int x, int y, int w, int h) {
+			_LastError = "";
+			if (!NeedScreen()) return;
+			PushViewState(false);
+			auto& VS{ _ViewStack.back() };
+			SDL_Rect C{ AltScreen.X(x), AltScreen.Y(y), AltScreen.W(w), AltScreen.H(h) };
+			if (VS.OldClipEnabled && !SDL_IntersectRect(&C, &VS.OldClip, &C)) C = { 0,0,0,0 };
+			// An empty clip rect means 'no clipping' to SDL, and that's the opposite of what's needed here.
+			if (C.w <= 0 || C.h <= 0) C = { -2,-2,1,1 };
+			SDL_RenderSetClipRect(_Screen->gRenderer, &C);
+		}
+
+		void PopClip() { PopViewState(false); }
+
+		size_t ViewDepth() { return _ViewStack.size(); }
+
+		bool Visible(int x, int y, int w, int h) {
+			return !Culled((float)AltScreen.X(x + _originx), (float)AltScreen.Y(y + _originy), (float)AltScreen.W(w), (float)AltScreen.H(h));
+		}
+#pragma endregion
+
 #pragma region GeneralCommands
-		int ASY(int y) { return AltScreen.Y(y); }
-		int ASX(int x) { return AltScreen.X(x); }
+		int ASY(int y) { return AltScreen.TrueY(y); }
+		int ASX(int x) { return AltScreen.TrueX(x); }
+		void AltScreenGPU(bool on) {
+			__RenderLock Lock(_RenderMutex);
+			_AltGPU = on;
+			ApplyAltScale();
+		}
+		bool AltScreenGPU() { return _AltGPU; }
+		void AltScreenRatio(double& x, double& y) {
+			x = AltScreen.GetW() > 0 ? AltScreen.RX() : 1;
+			y = AltScreen.GetH() > 0 ? AltScreen.RY() : 1;
+		}
 		void SetAlpha(byte a) { _alpha = a; _LastError = ""; }
+		byte GetAlpha() { return _alpha; }
 		void SetAlphaD(double a) {
 			a = std::min(a, (double)1); a = std::max((double)0, a);
 			SetAlpha((byte)floor(a * 255));
@@ -161,7 +380,18 @@ namespace Slyvina {
 			SetColor((byte)floor(rgb.r * 255), (byte)floor(rgb.g * 255), (byte)floor(rgb.b * 255));
 		}
 
-		void CloseGraphics() { _Screen = nullptr; }
+		// On the heap and never deleted, as hooks may be removed by static objects in other files destroyed after this one.
+		static std::map<std::string, TQSG_CloseHook>& CloseHooks() { static auto ret{ new std::map<std::string, TQSG_CloseHook>() }; return *ret; }
+		void AddCloseHook(std::string Name, TQSG_CloseHook Hook) { if (Hook) CloseHooks()[Name] = Hook; else CloseHooks().erase(Name); }
+		void RemoveCloseHook(std::string Name) { CloseHooks().erase(Name); }
+		static void RunCloseHooks() {
+			if (!_Screen) return;
+			auto Hooks{ CloseHooks() }; // A copy, as hooks may remove themselves
+			for (auto& H : Hooks) H.second();
+		}
+
+		void CloseGraphics() { StopRenderThread(); RunCloseHooks(); ForgetScene(); ForgetBackBuffer(); _ViewStack.clear(); _TargetStack.clear(); _Screen = nullptr; _GPUScaleX = 1; _GPUScaleY = 1; _BaseScaleX = 1; _BaseScaleY = 1; _InScene = false; }
+		SDL_Renderer* GetRenderer() { return _Screen ? _Screen->gRenderer : nullptr; }
 
 		inline bool NeedSDL() {
 			static bool Done{ false };
@@ -182,6 +412,8 @@ namespace Slyvina {
 		static bool TrueGraphics(int width, int height, bool fullscreen, std::string Title) {
 			Chat(TrSPrintF("Starting graphics screen: %dx%d; fullscreen=%d\n", width, height, fullscreen));
 			_LastError = "";
+			RunCloseHooks(); // The old renderer is about to go
+			ForgetScene();
 			_Screen = std::make_unique<__Screen>();
 
 			//Initialize SDL
@@ -240,6 +472,8 @@ namespace Slyvina {
 						return false;
 					}
 #endif
+					_GraphicsSession++;
+					ApplyAltScale();
 					Cls();
 					return true;
 				}
@@ -262,15 +496,41 @@ namespace Slyvina {
 			SetCLSColor((byte)floor(t.r * 255), (byte)floor(t.g * 255), (byte)floor(t.b * 255));
 		}
 
+		void GetCLSColor(byte& r, byte& g, byte& b) {
+			r = _clsr;
+			g = _clsg;
+			b = _clsb;
+		}
+
 		void Cls() {
-			Uint8  r, g, b, a;
 			_LastError = "";
 			if (!_Screen) {
 				_LastError = "CLS(): Impossible to comply without a graphics screen";
 				return;
 			}
+			Cls(_clsr, _clsg, _clsb);
+		}
+
+		void Cls(byte clsr, byte clsg, byte clsb) {
+			Uint8  r, g, b, a;
+			if (!_Screen) return;
+			if (_DirtyRedrawing && !_TargetStack.size()) {
+				// SDL_RenderClear ignores the clip rect, so that would wipe out the parts of the back buffer that were still good.
+				SDL_BlendMode bm;
+				SDL_GetRenderDrawColor(_Screen->gRenderer, &r, &g, &b, &a);
+				SDL_GetRenderDrawBlendMode(_Screen->gRenderer, &bm);
+				SDL_SetRenderDrawColor(_Screen->gRenderer, clsr, clsg, clsb, 255);
+				SDL_SetRenderDrawBlendMode(_Screen->gRenderer, SDL_BLENDMODE_NONE);
+				{
+					__TrueCoords TC;
+					SDL_RenderFillRect(_Screen->gRenderer, &_DirtyCurrent);
+				}
+				SDL_SetRenderDrawBlendMode(_Screen->gRenderer, bm);
+				SDL_SetRenderDrawColor(_Screen->gRenderer, r, g, b, a);
+				return;
+			}
 			SDL_GetRenderDrawColor(_Screen->gRenderer, &r, &g, &b, &a);
-			SDL_SetRenderDrawColor(_Screen->gRenderer, _clsr, _clsg, _clsb, 255);
+			SDL_SetRenderDrawColor(_Screen->gRenderer, clsr, clsg, clsb, 255);
 			SDL_RenderClear(_Screen->gRenderer);
 			SDL_SetRenderDrawColor(_Screen->gRenderer, r, g, b, a);
 		}
@@ -335,37 +595,233 @@ namespace Slyvina {
 			_scaley = h;
 		}
 
+		void GetScale(double& x, double& y) {
+			x = _scalex;
+			y = _scaley;
+		}
+
 		void SetOrigin(int x, int y) {
 			_originx = x;
 			_originy = y;
 		}
 
+		void GetOrigin(int& x, int& y) {
+			x = _originx;
+			y = _originy;
+		}
+
+		static std::atomic<Uint32> // WaitMinTicks() also runs on the render thread
+			_MinTicks{ 26 },
+			_LastSleep{ 0 }, // Time WaitMinTicks() spent waiting last time. The dynamic resolution governor doesn't count that as work.
+			_ThrottleSleep{ 0 }; // Time BackgroundThrottle() waited this frame, which is not work either
 		void WaitMinTicks(int minticks) {
 			if (!NeedScreen()) return;
 			//SDL_UpdateWindowSurface(gWindow);
 			static auto oud{ SDL_GetTicks() };
-			static auto mt{ 26 };
+			auto& mt{ _MinTicks };
 			if (minticks >= 0) mt = minticks;
+			auto start{ SDL_GetTicks() };
 			while (minticks && (SDL_GetTicks() - oud < mt)) SDL_Delay(1);
 			oud = SDL_GetTicks();
+			_LastSleep = (oud - start) + _ThrottleSleep.exchange(0);
+		}
+
+		static void ThreadedFlip(int minticks);
+		static bool _RTRunning{ false };
+
+		static std::map<std::string, TQSG_FlipHook> _FlipHooks{};
+		void AddFlipHook(std::string Name, TQSG_FlipHook Hook) {
+			__RenderLock Lock(_RenderMutex); // The render thread could be running the hooks right now
+			if (Hook) _FlipHooks[Name] = Hook; else _FlipHooks.erase(Name);
+		}
+		void RemoveFlipHook(std::string Name) {
+			__RenderLock Lock(_RenderMutex);
+			_FlipHooks.erase(Name);
+		}
+		static void RunFlipHooks() { for (auto& H : _FlipHooks) H.second(); }
+
+		static std::map<std::string, std::pair<TQSG_FlipHook, TQSG_FlipHook>> _PresentHooks{}; // Submitted, Presented
+		void AddPresentHooks(std::string Name, TQSG_FlipHook Submitted, TQSG_FlipHook Presented) {
+			__RenderLock Lock(_RenderMutex);
+			if (Submitted || Presented) _PresentHooks[Name] = { Submitted, Presented }; else _PresentHooks.erase(Name);
+		}
+		void RemovePresentHooks(std::string Name) {
+			__RenderLock Lock(_RenderMutex);
+			_PresentHooks.erase(Name);
+		}
+		static void RunSubmittedHooks() {
+			__RenderLock Lock(_RenderMutex);
+			for (auto& H : _PresentHooks) if (H.second.first) H.second.first();
+		}
+		static void RunPresentedHooks() {
+			__RenderLock Lock(_RenderMutex);
+			for (auto& H : _PresentHooks) if (H.second.second) H.second.second();
+		}
+
+		// Asked to SDL itself (which keeps these up to date whenever events are pumped), so TQSG doesn't depend on TQSE for this.
+		static Uint32 WindowFlags() { return (_Screen && _Screen->gWindow) ? SDL_GetWindowFlags(_Screen->gWindow) : 0; }
+		static bool WindowGone() { return WindowFlags() & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_HIDDEN); }
+		static bool WindowFocused() { return (!_Screen) || (WindowFlags() & SDL_WINDOW_INPUT_FOCUS); }
+
+#pragma region IdleMode
+		static bool
+			_IdleMode{ false },
+			_IdleWatching{ false };
+		static std::atomic<bool> _IdleChanged{ true }; // User events can be pushed from any thread
+		static Uint32 _IdleDeadline{ 0 }; // 0 means none
+		static int _IdleMaxWait{ 1000 };
+
+		static int SDLCALL IdleWatch(void*, SDL_Event* e) {
+			// Input and everything happening to the window can change what must be shown. SDL's own bookkeeping (like the poll sentinel) can't, and would otherwise wake us up all the time.
+			auto t{ e->type };
+			if ((t >= SDL_QUIT && t < SDL_CLIPBOARDUPDATE) ||
+				(t >= SDL_DROPFILE && t <= SDL_DROPCOMPLETE) ||
+				t == SDL_RENDER_TARGETS_RESET ||
+				t == SDL_RENDER_DEVICE_RESET ||
+				t >= SDL_USEREVENT) _IdleChanged = true;
+			return 0;
+		}
+
+		bool IdleMode(bool on, int MaxWait) {
+			_LastError = "";
+			if (on && !NeedScreen()) return false;
+			if (on && !_IdleWatching) {
+				SDL_AddEventWatch(IdleWatch, NULL);
+				_IdleWatching = true;
+			}
+			_IdleMode = on;
+			_IdleMaxWait = std::max(0, MaxWait);
+			_IdleDeadline = 0;
+			_IdleChanged = true;
+			return true;
+		}
+		bool IdleMode() { return _IdleMode; }
+
+		void MarkChanged() { _IdleChanged = true; }
+
+		void WakeIn(Uint32 ticks) {
+			Uint32 D{ SDL_GetTicks() + ticks };
+			if (!D) D = 1;
+			if ((!_IdleDeadline) || SDL_TICKS_PASSED(_IdleDeadline, D)) _IdleDeadline = D;
+		}
+
+		bool Changed() {
+			if (WindowGone()) return false; // Nobody would see it anyway
+			return (!_IdleMode) || _IdleChanged || (_IdleDeadline && SDL_TICKS_PASSED(SDL_GetTicks(), _IdleDeadline));
+		}
+
+		// True when Flip() can skip this frame. In that case this sleeps until there's something to do.
+		static bool IdleSkip() {
+			if ((!_IdleMode) || _RTRunning || (!_Screen)) return false;
+			if (Changed()) {
+				_IdleChanged = false;
+				if (_IdleDeadline && SDL_TICKS_PASSED(SDL_GetTicks(), _IdleDeadline)) _IdleDeadline = 0;
+				return false;
+			}
+			int Wait{ _IdleMaxWait };
+			if (_IdleDeadline) {
+				int Left{ std::max(1, (int)(_IdleDeadline - SDL_GetTicks())) };
+				Wait = Wait ? std::min(Wait, Left) : Left;
+			}
+			// With a NULL event SDL only waits, so whatever woke us up is still there for the next TQSE::Poll()
+			if (Wait) SDL_WaitEventTimeout(NULL, Wait); else SDL_WaitEvent(NULL);
+			return true;
 		}
+#pragma endregion
+
+#pragma region Throttle
+		static int _BackgroundFPS{ 10 };
+		static Uint32
+			_SuspendStart{ 0 }, // 0 when not suspended
+			_SuspendedTicks{ 0 },
+			_LastThrottle{ 0 };
+
+		// True when the window can't be seen, so Flip() can skip the frame. In that case this sleeps a while, or until something happens.
+		static bool SuspendSkip() {
+			bool Gone{ WindowGone() };
+			auto Now{ SDL_GetTicks() };
+			if (Gone && !_SuspendStart) _SuspendStart = Now ? Now : 1;
+			if ((!Gone) && _SuspendStart) {
+				_SuspendedTicks += Now - _SuspendStart;
+				_SuspendStart = 0;
+				_IdleChanged = true;
+			}
+			if (!Gone) return false;
+			if (_RTRunning || (!_Screen)) { SDL_Delay(100); return false; } // The render thread's draw lists must still be handed over, or they'd only grow
+			SDL_WaitEventTimeout(NULL, 100);
+			return true;
+		}
+
+		// Without the focus the game is not played, so showing a few frames per second is enough.
+		static void BackgroundThrottle() {
+			auto Now{ SDL_GetTicks() };
+			Uint32 Slept{ 0 };
+			if (_BackgroundFPS > 0 && !WindowFocused()) {
+				Uint32 Frame{ (Uint32)(1000 / _BackgroundFPS) };
+				if (Now - _LastThrottle < Frame) SDL_Delay(Frame - (Now - _LastThrottle)); // No waiting for events here, as mouse motion over the window would keep waking us up
+				Slept = SDL_GetTicks() - Now;
+				Now += Slept;
+			}
+			_ThrottleSleep = Slept;
+			_LastThrottle = Now;
+		}
+
+		void BackgroundFPS(int fps) { _BackgroundFPS = std::max(0, fps); }
+		int BackgroundFPS() { return _BackgroundFPS; }
+
+		bool Suspended() { return _SuspendStart != 0; }
+
+		Uint32 ActiveTicks() {
+			auto Now{ SDL_GetTicks() };
+			return Now - _SuspendedTicks - (_SuspendStart ? Now - _SuspendStart : 0);
+		}
+#pragma endregion
 
 		void Flip(int minticks) {
+			if (_InScene) {
+				EndScene();
+				_LastError = "Flip(): EndScene() was not called";
+			}
+			if (_TargetStack.size()) {
+				while (_TargetStack.size()) PopTarget();
+				_LastError = "Flip(): Not all draw targets were popped";
+			}
+			if (SuspendSkip()) return;
+			if (IdleSkip()) return;
+			BackgroundThrottle();
+			if (_RTRunning) { ThreadedFlip(minticks); return; }
+			if (_DirtyMode) { DirtyFlip(minticks); return; }
 			WaitMinTicks(minticks);
+			__RenderLock Lock(_RenderMutex);
+			RunFlipHooks();
+			RunSubmittedHooks();
 			SDL_RenderPresent(_Screen->gRenderer);
+			RunPresentedHooks();
+			DynamicGovernor();
+		}
+
+		static void RawLine(int start_x, int start_y, int end_x, int end_y, const TDrawState& State) {
+			if (Culled((float)std::min(start_x, end_x), (float)std::min(start_y, end_y), (float)abs(end_x - start_x) + 1, (float)abs(end_y - start_y) + 1)) return;
+			SDL_SetRenderDrawColor(_Screen->gRenderer, State.r, State.g, State.b, State.alpha);
+			SDL_RenderDrawLine(_Screen->gRenderer, start_x, start_y, end_x, end_y);
 		}
 
 		void Line(int start_x, int start_y, int end_x, int end_y) {
 			if (!NeedScreen()) return;
-			SDL_SetRenderDrawColor(_Screen->gRenderer, _red, _green, _blue, _alpha);
-			SDL_RenderDrawLine(_Screen->gRenderer, start_x, start_y, end_x, end_y);
+			Line(start_x, start_y, end_x, end_y, CurrentState());
 		}
 
+		void Line(int start_x, int start_y, int end_x, int end_y, const TDrawState& State) {
+			if (!_Screen) return;
+			__TrueCoords TC;
+			RawLine(start_x, start_y, end_x, end_y, State);
+		}
 
+		// Lines are placed by the alt screen, but must not get thicker, so the GPU can't scale these
 		void ALine(int start_x, int start_y, int end_x, int end_y) {
 			if (!NeedScreen()) return;
-			SDL_SetRenderDrawColor(_Screen->gRenderer, _red, _green, _blue, _alpha);
-			SDL_RenderDrawLine(_Screen->gRenderer, AltScreen.X(start_x), AltScreen.Y(start_y), AltScreen.X(end_x), AltScreen.Y(end_y));
+			__TrueCoords TC;
+			RawLine(AltScreen.TrueX(start_x), AltScreen.TrueY(start_y), AltScreen.TrueX(end_x), AltScreen.TrueY(end_y), CurrentState());
 		}
 
 		void Rect(int x, int y, int width, int height, bool open) {
@@ -383,10 +839,10 @@ namespace Slyvina {
 			Rect(startx, starty, endx - startx, endy - starty);
 		}
 
-		void Rect(SDL_Rect* r, bool open) {
-			if (!NeedScreen) return;
-			SDL_SetRenderDrawBlendMode(_Screen->gRenderer, (SDL_BlendMode)_blend);
-			SDL_SetRenderDrawColor(_Screen->gRenderer, _red, _green, _blue, _alpha);
+		static void RawRect(SDL_Rect* r, bool open, const TDrawState& State) {
+			if (r && Culled(*r)) return;
+			SDL_SetRenderDrawBlendMode(_Screen->gRenderer, (SDL_BlendMode)State.blend);
+			SDL_SetRenderDrawColor(_Screen->gRenderer, State.r, State.g, State.b, State.alpha);
 			if (open)
 				SDL_RenderDrawRect(_Screen->gRenderer, r);
 			else
@@ -394,34 +850,67 @@ namespace Slyvina {
 
 		}
 
+		void Rect(SDL_Rect* r, bool open) {
+			if (!NeedScreen()) return;
+			__TrueCoords TC;
+			RawRect(r, open, CurrentState());
+		}
+
+		void Rect(int x, int y, int w, int h, bool open, const TDrawState& State) {
+			if (!_Screen) return;
+			__TrueCoords TC;
+			SDL_Rect r{ x,y,w,h };
+			RawRect(&r, open, State);
+		}
+
 		void ARect(int x, int y, int w, int h, bool open) {
-			Rect(AltScreen.X(x), AltScreen.Y(y), AltScreen.W(w), AltScreen.H(h), open);
+			if (!NeedScreen()) return;
+			if (open) {
+				__TrueCoords TC; // Same story as ALine
+				SDL_Rect r{ AltScreen.TrueX(x), AltScreen.TrueY(y), AltScreen.TrueW(w), AltScreen.TrueH(h) };
+				RawRect(&r, true, CurrentState());
+				return;
+			}
+			SDL_Rect r{ AltScreen.X(x), AltScreen.Y(y), AltScreen.W(w), AltScreen.H(h) };
+			RawRect(&r, false, CurrentState());
 		}
 
 		void ACircle(int center_x, int center_y, int radius, int segments) {
+			if (!NeedScreen()) return;
+			__TrueCoords TC;
+			if (Culled((float)AltScreen.TrueX(center_x - radius), (float)AltScreen.TrueY(center_y - radius), (float)AltScreen.TrueW(radius * 2) + 1, (float)AltScreen.TrueH(radius * 2) + 1)) return;
+			auto State{ CurrentState() };
 			static double doublepi{ 2 * 3.14 };
 			double progress{ doublepi / (double)std::max(segments,4) };
 			float lastx = center_x, lasty = (radius)+center_y, firstx = lastx, firsty = lasty;
 			for (double i = 0; i < 2 * 3.14; i += progress) {
 				float cx = (sin(i) * radius) + center_x, cy = (cos(i) * radius) + center_y;
 				//SDL_RenderDrawLine(gRenderer, lastx, lasty, cx, cy);
-				Line(AltScreen.X((int)lastx), AltScreen.Y((int)lasty), AltScreen.X((int)cx), AltScreen.Y((int)cy));
+				RawLine(AltScreen.TrueX((int)lastx), AltScreen.TrueY((int)lasty), AltScreen.TrueX((int)cx), AltScreen.TrueY((int)cy), State);
 				lastx = cx; lasty = cy;
 			}
-			Line(AltScreen.X((int)lastx), AltScreen.Y((int)lasty), AltScreen.X((int)firstx), AltScreen.Y((int)firsty)); // Make sure the final segment is drawn as well.
+			RawLine(AltScreen.TrueX((int)lastx), AltScreen.TrueY((int)lasty), AltScreen.TrueX((int)firstx), AltScreen.TrueY((int)firsty), State); // Make sure the final segment is drawn as well.
 		}
 
 		void Circle(int center_x, int center_y, int radius, int segments) {
+			if (!NeedScreen()) return;
+			Circle(center_x, center_y, radius, segments, CurrentState());
+		}
+
+		void Circle(int center_x, int center_y, int radius, int segments, const TDrawState& State) {
+			if (!_Screen) return;
+			__TrueCoords TC;
+			if (Culled((float)(center_x - radius), (float)(center_y - radius), (float)(radius * 2) + 1, (float)(radius * 2) + 1)) return; // The lines would each be culled as well, but this saves all the sin/cos work
 			static double doublepi{ 2 * 3.14 };
 			double progress{ doublepi / (double)std::max(segments,4) };
 			float lastx = center_x, lasty = (radius)+center_y, firstx = lastx, firsty = lasty;
 			for (double i = 0; i < 2 * 3.14; i += progress) {
 				float cx = (sin(i) * radius) + center_x, cy = (cos(i) * radius) + center_y;
 				//SDL_RenderDrawLine(gRenderer, lastx, lasty, cx, cy);
-				Line((int)lastx, (int)lasty, (int)cx, (int)cy);
+				RawLine((int)lastx, (int)lasty, (int)cx, (int)cy, State);
 				lastx = cx; lasty = cy;
 			}
-			Line(lastx, lasty, firstx, firsty); // Make sure the final segment is drawn as well.
+			RawLine(lastx, lasty, firstx, firsty, State); // Make sure the final segment is drawn as well.
 		}
 
 		TImage LoadImage(std::string file) {
@@ -489,7 +978,14 @@ namespace Slyvina {
 		void Plot(int x, int y) {
 			_LastError = "";
 			if (!NeedScreen()) return;
-			SDL_SetRenderDrawColor(_Screen->gRenderer, _red, _green, _blue, _alpha);
+			Plot(x, y, CurrentState());
+		}
+
+		void Plot(int x, int y, const TDrawState& State) {
+			if (!_Screen) return;
+			__TrueCoords TC;
+			if (Culled((float)x, (float)y, 1, 1)) return;
+			SDL_SetRenderDrawColor(_Screen->gRenderer, State.r, State.g, State.b, State.alpha);
 			SDL_RenderDrawPoint(_Screen->gRenderer, x, y);
 		}
 
@@ -552,6 +1048,912 @@ namespace Slyvina {
 		}
 
 		void Rotate(double degrees) { _rotatedeg = degrees; }
+		double GetRotate() { return _rotatedeg; }
+#pragma endregion
+
+#pragma region QuadBatch
+		void TQuadBatch::Start(SDL_Texture* Tex, Blend _blend) {
+			if (Tex == _Tex && (SDL_BlendMode)_blend == _Blend) return;
+			Flush();
+			_Tex = Tex;
+			_Blend = (SDL_BlendMode)_blend;
+			if (_Tex) SDL_QueryTexture(_Tex, NULL, NULL, &_TexW, &_TexH);
+		}
+
+		void TQuadBatch::Add(const SDL_FRect& Target, const SDL_Rect* Source, byte r, byte g, byte b, byte a, double angle, SDL_FPoint center, int flip) {
+			if (!_Tex) return;
+#if SDL_VERSION_ATLEAST(2,0,18)
+			float
+				u1{ 0 }, v1{ 0 }, u2{ 1 }, v2{ 1 };
+			if (Source) {
+				u1 = (float)Source->x / _TexW;
+				v1 = (float)Source->y / _TexH;
+				u2 = (float)(Source->x + Source->w) / _TexW;
+				v2 = (float)(Source->y + Source->h) / _TexH;
+			}
+			if (flip & SDL_FLIP_HORIZONTAL) std::swap(u1, u2);
+			if (flip & SDL_FLIP_VERTICAL) std::swap(v1, v2);
+			// Corners relative to the rotation center, clockwise starting at top-left
+			float
+				cx[4]{ -center.x, Target.w - center.x, Target.w - center.x, -center.x },
+				cy[4]{ -center.y, -center.y, Target.h - center.y, Target.h - center.y },
+				tu[4]{ u1, u2, u2, u1 },
+				tv[4]{ v1, v1, v2, v2 };
+			float
+				cs{ 1 }, sn{ 0 };
+			if (angle) {
+				auto rad{ angle * PI / 180 };
+				cs = (float)cos(rad);
+				sn = (float)sin(rad);
+			}
+			int base{ (int)_Vertices.size() };
+			SDL_Color col{ r,g,b,a };
+			for (int i = 0; i < 4; i++) {
+				SDL_Vertex V;
+				V.position.x = Target.x + center.x + (cx[i] * cs) - (cy[i] * sn);
+				V.position.y = Target.y + center.y + (cx[i] * sn) + (cy[i] * cs);
+				V.color = col;
+				V.tex_coord.x = tu[i];
+				V.tex_coord.y = tv[i];
+				_Vertices.push_back(V);
+			}
+			_Indices.push_back(base); _Indices.push_back(base + 1); _Indices.push_back(base + 2);
+			_Indices.push_back(base); _Indices.push_back(base + 2); _Indices.push_back(base + 3);
+#else
+			// Old SDL versions have no geometry rendering, so no true batching is possible. Just draw it right away then.
+			if (!NeedScreen()) return;
+			SDL_Rect T{ (int)Target.x, (int)Target.y, (int)Target.w, (int)Target.h };
+			SDL_Point C{ (int)center.x, (int)center.y };
+			SDL_SetTextureBlendMode(_Tex, _Blend);
+			SDL_SetTextureAlphaMod(_Tex, a);
+			SDL_SetTextureColorMod(_Tex, r, g, b);
+			SDL_RenderCopyEx(_Screen->gRenderer, _Tex, Source, &T, angle, &C, (SDL_RendererFlip)flip);
+#endif
+		}
+
+		void TQuadBatch::Flush() {
+			if (!_Vertices.size()) return;
+			if (_Screen && _Tex) {
+				// Colours are set per vertex, so the texture modulation must be neutral.
+				SDL_SetTextureBlendMode(_Tex, _Blend);
+				SDL_SetTextureAlphaMod(_Tex, 255);
+				SDL_SetTextureColorMod(_Tex, 255, 255, 255);
+#if SDL_VERSION_ATLEAST(2,0,18)
+				SDL_RenderGeometry(_Screen->gRenderer, _Tex, _Vertices.data(), (int)_Vertices.size(), _Indices.data(), (int)_Indices.size());
+#endif
+			}
+			_Vertices.clear();
+			_Indices.clear();
+		}
+#pragma endregion
+
+#pragma region Workers
+		// Started the first time they're needed and kept until the end of the program, as starting threads every frame costs more than it gains.
+		static std::vector<std::thread> _PoolThreads{};
+		static std::mutex
+			_PoolMutex,
+			_PoolCaller; // One ParallelRun() at the time
+		static std::condition_variable
+			_PoolWork,
+			_PoolDone;
+		static std::function<void(size_t)> _PoolJob{ nullptr };
+		static size_t
+			_PoolNext{ 0 },
+			_PoolParts{ 0 },
+			_PoolBusy{ 0 };
+		static bool _PoolStop{ false };
+
+		static void PoolWorker() {
+			std::unique_lock<std::mutex> L(_PoolMutex);
+			while (true) {
+				_PoolWork.wait(L, [] { return _PoolStop || _PoolNext < _PoolParts; });
+				if (_PoolStop) return;
+				auto Part{ _PoolNext++ };
+				_PoolBusy++;
+				L.unlock();
+				_PoolJob(Part); // Not changed before all parts are done, so no need to lock
+				L.lock();
+				if (!--_PoolBusy) _PoolDone.notify_all();
+			}
+		}
+
+		void ParallelRun(size_t Parts, std::function<void(size_t)> Job) {
+			if (!Parts || !Job) return;
+			auto Cores{ std::max(1u, std::thread::hardware_concurrency()) };
+			if (Parts == 1 || Cores == 1) { for (size_t i = 0; i < Parts; i++) Job(i); return; }
+			std::lock_guard<std::mutex> C(_PoolCaller);
+			std::unique_lock<std::mutex> L(_PoolMutex);
+			if (!_PoolThreads.size()) {
+				_PoolStop = false;
+				for (unsigned i = 1; i < Cores; i++) _PoolThreads.push_back(std::thread(PoolWorker)); // The calling thread does its share too
+			}
+			_PoolJob = Job;
+			_PoolNext = 0;
+			_PoolParts = Parts;
+			_PoolWork.notify_all();
+			while (_PoolNext < _PoolParts) {
+				auto Part{ _PoolNext++ };
+				_PoolBusy++;
+				L.unlock();
+				Job(Part);
+				L.lock();
+				_PoolBusy--;
+			}
+			_PoolDone.wait(L, [] { return !_PoolBusy; });
+			_PoolParts = 0;
+			_PoolNext = 0;
+			_PoolJob = nullptr;
+		}
+
+		class __PoolGuard { // The threads must be gone before the things they use are
+		public:
+			inline ~__PoolGuard() {
+				{
+					std::lock_guard<std::mutex> L(_PoolMutex);
+					_PoolStop = true;
+				}
+				_PoolWork.notify_all();
+				for (auto& T : _PoolThreads) if (T.joinable()) T.join();
+				_PoolThreads.clear();
+			}
+		};
+		static __PoolGuard _PoolGuard;
+#pragma endregion
+
+#pragma region RenderThread
+		class __RenderFrame {
+		public:
+			_____TDRAWLIST Main{};
+			std::vector<TDrawList> Extra{};
+		};
+		static __RenderFrame _RTFrames[2]{};
+		static int
+			_RTBack{ 0 },
+			_RTFront{ 0 },
+			_RTMinTicks{ -1 };
+		static bool
+			_RTFrameReady{ false },
+			_RTBusy{ false },
+			_RTStop{ false };
+		static std::thread _RTThread;
+		static std::mutex _RTMutex;
+		static std::condition_variable _RTCV;
+
+		static void RenderThreadLoop() {
+			Chat("Render thread started");
+			while (true) {
+				int f, minticks;
+				{
+					std::unique_lock<std::mutex> L(_RTMutex);
+					_RTCV.wait(L, [] {return _RTFrameReady || _RTStop; });
+					if (!_RTFrameReady) break; // Stop requested and nothing left to show
+					f = _RTFront;
+					minticks = _RTMinTicks;
+					_RTFrameReady = false;
+					_RTBusy = true;
+				}
+				{
+					__RenderLock Lock(_RenderMutex);
+					std::vector<_____TDRAWLIST*> Lists{ &_RTFrames[f].Main };
+					for (auto& E : _RTFrames[f].Extra) Lists.push_back(E.get());
+					ReplayDrawLists(Lists);
+				}
+				WaitMinTicks(minticks); // Not while locked, as image loading would have to wait for it too.
+				{
+					__RenderLock Lock(_RenderMutex);
+					if (_Screen) {
+						RunFlipHooks();
+						SDL_RenderPresent(_Screen->gRenderer);
+						RunPresentedHooks();
+					}
+				}
+				_RTFrames[f].Main.Clear();
+				_RTFrames[f].Extra.clear();
+				{
+					std::lock_guard<std::mutex> L(_RTMutex);
+					_RTBusy = false;
+				}
+				_RTCV.notify_all();
+			}
+			Chat("Render thread ended");
+		}
+
+		static void ThreadedFlip(int minticks) {
+			std::unique_lock<std::mutex> L(_RTMutex);
+			// The render thread may be one frame behind, never more.
+			_RTCV.wait(L, [] {return !(_RTFrameReady || _RTBusy); });
+			_RTFront = _RTBack;
+			_RTBack = 1 - _RTBack;
+			_RTMinTicks = minticks;
+			_RTFrameReady = true;
+			RunSubmittedHooks(); // Still locked, so the render thread can't present this frame before the hooks know it was handed over
+			L.unlock();
+			_RTCV.notify_all();
+		}
+
+		bool StartRenderThread() {
+			_LastError = "";
+			if (!NeedScreen()) return false;
+			if (_RTRunning) return true;
+			_RTStop = false;
+			_RTFrameReady = false;
+			_RTBusy = false;
+			_RTBack = 0;
+			_RTRunning = true;
+			_RTThread = std::thread(RenderThreadLoop);
+			return true;
+		}
+
+		void StopRenderThread() {
+			if (!_RTRunning) return;
+			{
+				std::lock_guard<std::mutex> L(_RTMutex);
+				_RTStop = true;
+			}
+			_RTCV.notify_all();
+			if (_RTThread.joinable()) _RTThread.join();
+			_RTRunning = false;
+			_RTFrames[_RTBack].Main.Clear();
+			_RTFrames[_RTBack].Extra.clear();
+		}
+
+		bool RenderThreaded() { return _RTRunning; }
+
+		_____TDRAWLIST* FrameList() { return &_RTFrames[_RTBack].Main; }
+
+		void SubmitToFrame(TDrawList List) { if (List) _RTFrames[_RTBack].Extra.push_back(List); }
+
+		class __RenderThreadGuard { // Makes sure the thread is gone before the screen is, or C++ will crash at the end of the program
+		public:
+			inline ~__RenderThreadGuard() { StopRenderThread(); }
+		};
+		static __RenderThreadGuard _RTGuard;
+#pragma endregion
+
+#pragma region DirtyRects
+		static TQSG_DirtyRedraw _DirtyRedraw{ nullptr };
+		static SDL_Texture* _BackBuffer{ nullptr };
+		static int
+			_BackBufferW{ 0 },
+			_BackBufferH{ 0 };
+		static std::vector<SDL_Rect> _DirtyRects{};
+		static bool _DirtyWatching{ false };
+
+		static void ForgetBackBuffer() {
+			// When the renderer is destroyed it takes the texture with it, so this only has to be destroyed when the screen is still there
+			if (_BackBuffer && _Screen) {
+				SDL_SetRenderTarget(_Screen->gRenderer, NULL);
+				SDL_DestroyTexture(_BackBuffer);
+			}
+			_BackBuffer = nullptr;
+			_DirtyMode = false;
+			_DirtyRects.clear();
+		}
+
+		static int SDLCALL DirtyWatch(void*, SDL_Event* e) {
+			// Whatever makes the content of the window or the back buffer unreliable, means everything must be redrawn.
+			switch (e->type) {
+			case SDL_RENDER_TARGETS_RESET:
+			case SDL_RENDER_DEVICE_RESET:
+				MarkAllDirty();
+				break;
+			case SDL_WINDOWEVENT:
+				switch (e->window.event) {
+				case SDL_WINDOWEVENT_EXPOSED:
+				case SDL_WINDOWEVENT_RESIZED:
+				case SDL_WINDOWEVENT_SIZE_CHANGED:
+				case SDL_WINDOWEVENT_RESTORED:
+					MarkAllDirty();
+					break;
+				}
+				break;
+			}
+			return 0;
+		}
+
+		static bool NeedBackBuffer() {
+			int w, h;
+			SDL_GetRendererOutputSize(_Screen->gRenderer, &w, &h);
+			if (_BackBuffer && w == _BackBufferW && h == _BackBufferH) return true;
+			if (_BackBuffer) {
+				SDL_SetRenderTarget(_Screen->gRenderer, NULL);
+				SDL_DestroyTexture(_BackBuffer);
+			}
+			_BackBuffer = SDL_CreateTexture(_Screen->gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+			if (!_BackBuffer) {
+				_LastError = TrSPrintF("Back buffer could not be created! SDL Error: %s", SDL_GetError());
+				return false;
+			}
+			SDL_SetTextureBlendMode(_BackBuffer, SDL_BLENDMODE_NONE);
+			_BackBufferW = w;
+			_BackBufferH = h;
+			SDL_SetRenderTarget(_Screen->gRenderer, _BackBuffer);
+			ApplyAltScale(); // Setting a target resets the scale
+			MarkAllDirty();
+			return true;
+		}
+
+		static std::vector<SDL_Rect> MergedDirtyRects() {
+			std::vector<SDL_Rect> ret{};
+			SDL_Rect Scr{ 0,0,_BackBufferW,_BackBufferH };
+			for (auto R : _DirtyRects) {
+				if (!SDL_IntersectRect(&R, &Scr, &R)) continue;
+				ret.push_back(R);
+			}
+			// Rects which overlap or touch become one. Merging could make a rect touch another one, so go on until nothing changes anymore.
+			bool merged{ true };
+			while (merged) {
+				merged = false;
+				for (size_t i = 0; i < ret.size() && !merged; i++) for (size_t j = i + 1; j < ret.size() && !merged; j++) {
+					SDL_Rect Grown{ ret[i].x - 1, ret[i].y - 1, ret[i].w + 2, ret[i].h + 2 };
+					if (SDL_HasIntersection(&Grown, &ret[j])) {
+						SDL_UnionRect(&ret[i], &ret[j], &ret[i]);
+						ret.erase(ret.begin() + j);
+						merged = true;
+					}
+				}
+			}
+			// When most of the screen has to be redrawn anyway, one redraw of everything is cheaper than many small ones.
+			int64 area{ 0 };
+			for (auto& R : ret) area += (int64)R.w * R.h;
+			if (ret.size() > 1 && area * 2 > (int64)_BackBufferW * _BackBufferH) ret = { Scr };
+			return ret;
+		}
+
+		static void DirtyFlip(int minticks) {
+			WaitMinTicks(minticks);
+			__RenderLock Lock(_RenderMutex);
+			auto Rend{ _Screen->gRenderer };
+			if (!NeedBackBuffer()) { RunFlipHooks(); RunSubmittedHooks(); SDL_RenderPresent(Rend); RunPresentedHooks(); return; }
+			if (!_DirtyRects.size()) return; // Nothing changed, so what's in the window is still good. Input polled till now counts for the next frame that is presented.
+			auto Rects{ MergedDirtyRects() };
+			_DirtyRects.clear();
+			if (_DirtyRedraw) {
+				for (auto& R : Rects) {
+					{
+						__TrueCoords TC; // R is in true pixels
+						SDL_RenderSetClipRect(Rend, &R);
+					}
+					_DirtyCurrent = R;
+					_DirtyRedrawing = true;
+					Cls();
+					_DirtyRedraw(R);
+					_DirtyRedrawing = false;
+				}
+				SDL_RenderSetClipRect(Rend, NULL);
+			}
+			// The content of the window is undefined after presenting, so the full back buffer must be copied every time. That's only one quad though.
+			SDL_SetRenderTarget(Rend, NULL);
+			SDL_RenderCopy(Rend, _BackBuffer, NULL, NULL);
+			RunFlipHooks();
+			RunSubmittedHooks();
+			SDL_RenderPresent(Rend);
+			RunPresentedHooks();
+			SDL_SetRenderTarget(Rend, _BackBuffer);
+			ApplyAltScale();
+		}
+
+		bool DirtyRectMode(bool on, TQSG_DirtyRedraw Redraw) {
+			_LastError = "";
+			if (!on) {
+				ForgetBackBuffer();
+				_DirtyRedraw = nullptr;
+				return true;
+			}
+			if (!NeedScreen()) return false;
+			if (_RTRunning) {
+				_LastError = "Dirty rect mode and the render thread cannot be combined";
+				return false;
+			}
+			__RenderLock Lock(_RenderMutex);
+			_DirtyRedraw = Redraw;
+			if (!NeedBackBuffer()) return false;
+			if (!_DirtyWatching) {
+				SDL_AddEventWatch(DirtyWatch, NULL);
+				_DirtyWatching = true;
+			}
+			_DirtyMode = true;
+			MarkAllDirty();
+			return true;
+		}
+
+		bool DirtyRectMode() { return _DirtyMode; }
+
+		void MarkDirty(int x, int y, int w, int h) {
+			_IdleChanged = true;
+			if (!_DirtyMode || w <= 0 || h <= 0) return;
+			x += _originx;
+			y += _originy;
+			// One pixel extra on all sides, as the alt screen rounding could otherwise leave a thin line behind.
+			_DirtyRects.push_back({ AltScreen.TrueX(x) - 1, AltScreen.TrueY(y) - 1, AltScreen.TrueW(w) + 2, AltScreen.TrueH(h) + 2 });
+		}
+
+		void MarkAllDirty() {
+			_IdleChanged = true;
+			if (!_DirtyMode) return;
+			_DirtyRects.clear();
+			_DirtyRects.push_back({ 0,0,_BackBufferW,_BackBufferH });
+		}
+#pragma endregion
+
+#pragma region Canvas
+		// These live on the heap and are never deleted, as canvases kept in static variables may be destroyed after everything in here is.
+		typedef std::map<std::pair<int, int>, std::vector<SDL_Texture*>> __CanvasPool;
+		static __CanvasPool& CanvasPool() { static auto ret{ new __CanvasPool() }; return *ret; }
+		static uint64
+			_CanvasPoolSession{ 0 },
+			_TargetResets{ 0 },
+			_DeviceResets{ 0 };
+		static bool _CanvasWatching{ false };
+
+		static int SDLCALL CanvasWatch(void*, SDL_Event* e) {
+			// Only count here. The canvases find out when they're used next, as this may not be the right moment (or thread) to draw.
+			switch (e->type) {
+			case SDL_RENDER_TARGETS_RESET: _TargetResets++; break;
+			case SDL_RENDER_DEVICE_RESET: _DeviceResets++; break;
+			}
+			return 0;
+		}
+
+		static SDL_Texture* AcquireCanvasTexture(int w, int h) {
+			auto& Pool{ CanvasPool() };
+			if (_CanvasPoolSession != _GraphicsSession) {
+				Pool.clear(); // The old renderer took these with it
+				_CanvasPoolSession = _GraphicsSession;
+			}
+			auto& Free{ Pool[{w, h}] };
+			if (Free.size()) {
+				auto ret{ Free.back() };
+				Free.pop_back();
+				return ret;
+			}
+			auto ret{ SDL_CreateTexture(_Screen->gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h) };
+			if (!ret) {
+				_LastError = TrSPrintF("Canvas texture %dx%d could not be created! SDL Error: %s", w, h, SDL_GetError());
+				return nullptr;
+			}
+			SDL_SetTextureBlendMode(ret, SDL_BLENDMODE_BLEND);
+			return ret;
+		}
+
+		static void ReleaseCanvasTexture(SDL_Texture* Tex, int w, int h, uint64 Session) {
+			if (!Tex || !_Screen || Session != _GraphicsSession) return; // No renderer or another one, so the texture is already gone
+			if (_CanvasPoolSession != _GraphicsSession) {
+				CanvasPool().clear();
+				_CanvasPoolSession = _GraphicsSession;
+			}
+			// The next owner must get it the way a freshly created texture would be
+			SDL_SetTextureBlendMode(Tex, SDL_BLENDMODE_BLEND);
+			SDL_SetTextureAlphaMod(Tex, 255);
+			SDL_SetTextureColorMod(Tex, 255, 255, 255);
+#if SDL_VERSION_ATLEAST(2,0,12)
+			auto Quality{ SDL_GetHint(SDL_HINT_RENDER_SCALE_QUALITY) };
+			auto Mode{ SDL_ScaleModeNearest };
+			if (Quality) {
+				std::string Q{ Quality };
+				if (Q == "1" || Q == "linear") Mode = SDL_ScaleModeLinear;
+				else if (Q == "2" || Q == "best") Mode = SDL_ScaleModeBest;
+			}
+			SDL_SetTextureScaleMode(Tex, Mode);
+#endif
+			CanvasPool()[{w, h}].push_back(Tex);
+		}
+
+		void ClearCanvasPool() {
+			__RenderLock Lock(_RenderMutex);
+			if (_Screen && _CanvasPoolSession == _GraphicsSession) {
+				for (auto& P : CanvasPool()) for (auto T : P.second) SDL_DestroyTexture(T);
+			}
+			CanvasPool().clear();
+		}
+
+		// Fills a texture without disturbing the current target, viewport or clip rect
+		static void FillTexture(SDL_Texture* Tex, byte r, byte g, byte b, byte a) {
+			auto Rend{ _Screen->gRenderer };
+			auto OldTarget{ SDL_GetRenderTarget(Rend) };
+			SDL_Rect VP, Clip;
+			SDL_RenderGetViewport(Rend, &VP);
+			bool ClipEnabled{ (bool)SDL_RenderIsClipEnabled(Rend) };
+			SDL_RenderGetClipRect(Rend, &Clip);
+			Uint8 cr, cg, cb, ca;
+			SDL_GetRenderDrawColor(Rend, &cr, &cg, &cb, &ca);
+			SDL_SetRenderTarget(Rend, Tex);
+			SDL_SetRenderDrawColor(Rend, r, g, b, a);
+			SDL_RenderClear(Rend);
+			SDL_SetRenderDrawColor(Rend, cr, cg, cb, ca);
+			SDL_SetRenderTarget(Rend, OldTarget);
+			ApplyAltScale(); // Before the viewport, as that one is relative to the scale
+			SDL_RenderSetViewport(Rend, &VP);
+			SDL_RenderSetClipRect(Rend, ClipEnabled ? &Clip : NULL);
+		}
+
+		bool _____TCANVAS::Check() {
+			if (!_Screen) return false;
+			__RenderLock Lock(_RenderMutex);
+			if (_Tex && _Session != _GraphicsSession) _Tex = nullptr; // The renderer it belonged to is gone
+			if (_Tex && _DeviceResets != ::Slyvina::TQSG::_DeviceResets) {
+				SDL_DestroyTexture(_Tex);
+				_Tex = nullptr;
+				ClearCanvasPool(); // Those are just as worthless now
+			}
+			if (_TargetResets != ::Slyvina::TQSG::_TargetResets) _Lost = true;
+			_TargetResets = ::Slyvina::TQSG::_TargetResets;
+			_DeviceResets = ::Slyvina::TQSG::_DeviceResets;
+			if (!_Tex) {
+				_Tex = AcquireCanvasTexture(_W, _H);
+				if (!_Tex) return false;
+				_Session = _GraphicsSession;
+				_Img->Textures = { _Tex };
+				_Lost = true;
+			}
+			if (_Lost && !_Restoring) {
+				FillTexture(_Tex, 0, 0, 0, 0); // Don't show whatever garbage was left in there
+				if (OnRestore) {
+					_Restoring = true;
+					if (PushTarget(this)) {
+						OnRestore(this);
+						PopTarget();
+					}
+					_Restoring = false;
+					_Lost = false;
+				}
+			}
+			return true;
+		}
+
+		bool _____TCANVAS::Lost() {
+			Check();
+			return _Lost;
+		}
+
+		void _____TCANVAS::Clear(byte r, byte g, byte b, byte a) {
+			if (!Check()) return;
+			FillTexture(_Tex, r, g, b, a);
+		}
+
+		SDL_Texture* _____TCANVAS::GetTexture() { return Check() ? _Tex : nullptr; }
+
+		TImage _____TCANVAS::Image() {
+			Check();
+			return _Img;
+		}
+
+		void _____TCANVAS::Draw(int x, int y) { if (Check()) _Img->Draw(x, y); }
+		void _____TCANVAS::XDraw(int x, int y) { if (Check()) _Img->XDraw(x, y); }
+		void _____TCANVAS::StretchDraw(int x, int y, int w, int h) { if (Check()) _Img->StretchDraw(x, y, w, h); }
+
+		_____TCANVAS::_____TCANVAS(int w, int h) {
+			_W = std::max(1, w);
+			_H = std::max(1, h);
+			_Img = std::make_shared<_____TIMAGE>();
+			if (!_CanvasWatching) {
+				SDL_AddEventWatch(CanvasWatch, NULL);
+				_CanvasWatching = true;
+			}
+			_TargetResets = ::Slyvina::TQSG::_TargetResets;
+			_DeviceResets = ::Slyvina::TQSG::_DeviceResets;
+			Check();
+		}
+
+		_____TCANVAS::~_____TCANVAS() {
+			_Img->Textures.clear(); // The image doesn't own it, so it may not destroy it
+			if (!_Screen) return; // The renderer already took the texture with it
+			__RenderLock Lock(_RenderMutex);
+			ReleaseCanvasTexture(_Tex, _W, _H, _Session);
+		}
+
+		TCanvas CreateCanvas(int w, int h) {
+			_LastError = "";
+			if (!NeedScreen()) return nullptr;
+			auto ret{ std::make_shared<_____TCANVAS>(w, h) };
+			if (!ret->GetTexture()) return nullptr;
+			return ret;
+		}
+
+		TUCanvas CreateUCanvas(int w, int h) {
+			_LastError = "";
+			if (!NeedScreen()) return nullptr;
+			auto ret{ std::make_unique<_____TCANVAS>(w, h) };
+			if (!ret->GetTexture()) return nullptr;
+			return ret;
+		}
+
+		bool PushTarget(_____TCANVAS* Canvas) {
+			_LastError = "";
+			if (!NeedScreen()) return false;
+			if (!Canvas) { _LastError = "PushTarget(): No canvas"; return false; }
+			if (_RTRunning) { _LastError = "PushTarget(): Not possible while the render thread runs"; return false; }
+			__RenderLock Lock(_RenderMutex);
+			if (!Canvas->Check()) return false;
+			auto Rend{ _Screen->gRenderer };
+			__TargetState TS;
+			TS.OldTarget = SDL_GetRenderTarget(Rend);
+			SDL_RenderGetViewport(Rend, &TS.OldViewport);
+			TS.OldClipEnabled = SDL_RenderIsClipEnabled(Rend);
+			SDL_RenderGetClipRect(Rend, &TS.OldClip);
+			TS.AltW = AltScreen.GetW();
+			TS.AltH = AltScreen.GetH();
+			TS.ViewDepth = _ViewStack.size();
+			if (SDL_SetRenderTarget(Rend, Canvas->_Tex)) {
+				_LastError = TrSPrintF("PushTarget(): %s", SDL_GetError());
+				return false;
+			}
+			SDL_RenderSetClipRect(Rend, NULL);
+			AltScreen.SetW(0);
+			AltScreen.SetH(0);
+			_TargetStack.push_back(TS);
+			Canvas->_Lost = false;
+			return true;
+		}
+
+		void PopTarget() {
+			_LastError = "";
+			if (!NeedScreen()) return;
+			if (!_TargetStack.size()) { _LastError = "PopTarget(): Nothing to pop"; return; }
+			__RenderLock Lock(_RenderMutex);
+			auto TS{ _TargetStack.back() };
+			_TargetStack.pop_back();
+			auto Rend{ _Screen->gRenderer };
+			std::string Err{ "" }; // Only set at the end, as restoring the alt screen clears _LastError
+			if (_ViewStack.size() > TS.ViewDepth) {
+				Err = "PopTarget(): Viewports or clip rects pushed on this canvas were not popped";
+				_ViewStack.resize(TS.ViewDepth);
+			}
+			SDL_SetRenderTarget(Rend, TS.OldTarget);
+			AltScreen.SetW(TS.AltW); // Before the viewport, as in GPU alt screen mode this brings back the scale that viewport is relative to
+			AltScreen.SetH(TS.AltH);
+			SDL_RenderSetViewport(Rend, &TS.OldViewport);
+			SDL_RenderSetClipRect(Rend, TS.OldClipEnabled ? &TS.OldClip : NULL);
+			_LastError = Err;
+		}
+#pragma endregion
+
+#pragma region DynamicResolution
+		static bool _DynRes{ false };
+		static double
+			_DynFloor{ 0.5 },
+			_DynScale{ 1 },
+			_DynAvg{ 0 };
+		static int
+			_DynTicks{ 0 },
+			_DynCooldown{ 0 },
+			_SceneW{ 0 },
+			_SceneH{ 0 };
+		static Uint32 _LastPresent{ 0 };
+		static size_t _SceneViewDepth{ 0 };
+		static TUCanvas _SceneCanvas{ nullptr };
+		static SDL_Texture* _SceneTex{ nullptr }; // What BeginScene() bound. Asking the canvas again would clear it, as it can't know it was drawn in.
+
+		class __ScreenCloser { // Releases the canvases (also the static ones in other files) while the renderer is still there, when the program ends without CloseGraphics()
+		public:
+			inline ~__ScreenCloser() { CloseGraphics(); }
+		};
+		static __ScreenCloser _ScreenCloser;
+
+		// Called by Flip() right after presenting. Only goes down or up after a few frames, or it would keep jumping back and forth.
+		static void DynamicGovernor() {
+			auto Now{ SDL_GetTicks() };
+			if (_DynRes && _LastPresent) {
+				double
+					Busy{ (double)(Now - _LastPresent) - _LastSleep },
+					Budget{ (double)(_DynTicks > 0 ? _DynTicks : (_MinTicks > 0 ? _MinTicks.load() : 16)) };
+				if (Busy < Budget * 4) { // Anything slower was a hiccup (loading or a window being dragged) and says nothing about the drawing
+					_DynAvg = _DynAvg > 0 ? (_DynAvg * 0.8) + (Busy * 0.2) : Busy;
+					if (_DynCooldown) _DynCooldown--;
+					else if (_DynAvg > Budget * 0.95 && _DynScale > _DynFloor) {
+						_DynScale = std::max(_DynFloor, _DynScale * 0.9);
+						_DynCooldown = 10;
+					} else if (_DynAvg < Budget * 0.7 && _DynScale < 1) {
+						_DynScale = std::min(1.0, _DynScale + 0.05);
+						_DynCooldown = 10;
+					}
+				}
+			}
+			_LastPresent = Now;
+		}
+
+		bool DynamicResolution(bool on, double Floor, int TargetTicks) {
+			_LastError = "";
+			if (on && (_RTRunning || _DirtyMode)) {
+				_LastError = "Dynamic resolution can't be combined with the render thread or dirty rect mode";
+				return false;
+			}
+			if (_InScene) EndScene();
+			_DynRes = on;
+			_DynFloor = std::min(1.0, std::max(0.1, Floor));
+			_DynTicks = std::max(0, TargetTicks);
+			_DynScale = 1;
+			_DynAvg = 0;
+			_DynCooldown = 0;
+			if (!on) ForgetScene();
+			return true;
+		}
+
+		static void ForgetScene() {
+			_SceneCanvas = nullptr;
+			_SceneTex = nullptr;
+		}
+		bool DynamicResolution() { return _DynRes; }
+		double DynamicResolutionScale() { return _DynRes ? _DynScale : 1; }
+
+		bool BeginScene() {
+			_LastError = "";
+			if (!NeedScreen()) return false;
+			if (!_DynRes) return false; // Then everything just goes to the screen
+			if (_InScene) { _LastError = "BeginScene(): Already in a scene"; return false; }
+			if (_RTRunning || _DirtyMode || _TargetStack.size()) { _LastError = "BeginScene(): Not possible with the render thread, dirty rect mode or a canvas as draw target"; return false; }
+			__RenderLock Lock(_RenderMutex);
+			auto Rend{ _Screen->gRenderer };
+			int w, h;
+			SDL_GetRendererOutputSize(Rend, &w, &h);
+			// The texture is always full size. Only the part the current scale needs is drawn in, so changing the scale costs nothing.
+			if (!_SceneCanvas || _SceneCanvas->Width() != w || _SceneCanvas->Height() != h) _SceneCanvas = CreateUCanvas(w, h);
+			if (!_SceneCanvas) return false;
+			auto Tex{ _SceneCanvas->GetTexture() };
+			if (!Tex) return false;
+			if (SDL_SetRenderTarget(Rend, Tex)) {
+				_LastError = TrSPrintF("BeginScene(): %s", SDL_GetError());
+				return false;
+			}
+			_SceneTex = Tex;
+			_SceneCanvas->_Lost = false; // Bound as target, just like PushTarget() does, so the next GetTexture() won't wipe it
+			_SceneW = std::max(1, (int)round(w * _DynScale));
+			_SceneH = std::max(1, (int)round(h * _DynScale));
+			SDL_Rect VP{ 0,0,_SceneW,_SceneH };
+			SDL_RenderSetViewport(Rend, &VP); // The target starts without scaling, so this is in true pixels
+			_BaseScaleX = (double)_SceneW / w;
+			_BaseScaleY = (double)_SceneH / h;
+			ApplyAltScale();
+			_SceneViewDepth = _ViewStack.size();
+			_InScene = true;
+			return true;
+		}
+
+		void EndScene() {
+			_LastError = "";
+			if (!_InScene) return;
+			__RenderLock Lock(_RenderMutex);
+			_InScene = false;
+			if (_ViewStack.size() > _SceneViewDepth) {
+				_LastError = "EndScene(): Viewports or clip rects pushed in the scene were not popped";
+				_ViewStack.resize(_SceneViewDepth);
+			}
+			auto Rend{ _Screen->gRenderer };
+			_BaseScaleX = 1;
+			_BaseScaleY = 1;
+			SDL_SetRenderTarget(Rend, NULL); // SDL restores the viewport, clip rect and scale of the screen by itself
+			ApplyAltScale();
+			auto Tex{ _SceneTex };
+			if (!Tex) return;
+			SDL_SetTextureBlendMode(Tex, SDL_BLENDMODE_NONE);
+			SDL_SetTextureAlphaMod(Tex, 255);
+			SDL_SetTextureColorMod(Tex, 255, 255, 255);
+#if SDL_VERSION_ATLEAST(2,0,12)
+			SDL_SetTextureScaleMode(Tex, SDL_ScaleModeLinear);
+#endif
+			SDL_Rect
+				Source{ 0,0,_SceneW,_SceneH },
+				VP;
+			__TrueCoords TC;
+			SDL_RenderGetViewport(Rend, &VP);
+			SDL_RenderSetViewport(Rend, NULL); // Always the full window, even when a viewport was pushed before the scene began
+			SDL_RenderCopy(Rend, Tex, &Source, NULL);
+			SDL_RenderSetViewport(Rend, &VP);
+		}
+#pragma endregion
+
+#pragma region Cursor
+		struct __CachedCursor {
+			TImage Img; // Kept, so the address the cache knows the image by can't be taken by another image
+			SDL_Cursor* Cursor;
+		};
+		static std::map<std::tuple<_____TIMAGE*, int, int, int>, __CachedCursor> _Cursors{};
+		static SDL_Cursor* _CurrentCursor{ nullptr };
+
+		// The texture of the frame is drawn onto a canvas of the cursor size and read back, as the loaded pixels are gone by now.
+		static SDL_Cursor* MakeCursor(TImage Img, int frame, int w, int h, int hx, int hy) {
+			auto Rend{ _Screen->gRenderer };
+			__RenderLock Lock(_RenderMutex);
+			SDL_FRect Target{ 0, 0, (float)w, (float)h };
+			SDL_Rect Source{ 0,0,0,0 };
+			auto Tex{ Img->MapFrame(frame, Target, Source) };
+			auto Canvas{ SDL_CreateTexture(Rend, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, w, h) };
+			auto Surf{ SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888) };
+			if (!Canvas || !Surf) {
+				_LastError = TrSPrintF("ImageCursor(): Could not create a %dx%d cursor: %s", w, h, SDL_GetError());
+				if (Canvas) SDL_DestroyTexture(Canvas);
+				if (Surf) SDL_FreeSurface(Surf);
+				return nullptr;
+			}
+			auto OldTarget{ SDL_GetRenderTarget(Rend) };
+			SDL_Rect VP, Clip;
+			SDL_RenderGetViewport(Rend, &VP);
+			bool ClipEnabled{ (bool)SDL_RenderIsClipEnabled(Rend) };
+			SDL_RenderGetClipRect(Rend, &Clip);
+			Uint8 cr, cg, cb, ca;
+			SDL_GetRenderDrawColor(Rend, &cr, &cg, &cb, &ca);
+			SDL_SetRenderTarget(Rend, Canvas);
+			SDL_SetRenderDrawColor(Rend, 0, 0, 0, 0);
+			SDL_RenderClear(Rend);
+			if (Tex) { // Nothing when trimming left nothing
+				Uint8 tr, tg, tb, ta;
+				SDL_BlendMode tm;
+				SDL_GetTextureColorMod(Tex, &tr, &tg, &tb);
+				SDL_GetTextureAlphaMod(Tex, &ta);
+				SDL_GetTextureBlendMode(Tex, &tm);
+				SDL_SetTextureColorMod(Tex, 255, 255, 255);
+				SDL_SetTextureAlphaMod(Tex, 255);
+				SDL_SetTextureBlendMode(Tex, SDL_BLENDMODE_NONE); // The alpha must end up in the cursor as it is
+#if SDL_VERSION_ATLEAST(2,0,10)
+				SDL_RenderCopyF(Rend, Tex, &Source, &Target);
+#else
+				SDL_Rect ITarget{ (int)floor(Target.x), (int)floor(Target.y), (int)ceil(Target.w), (int)ceil(Target.h) };
+				SDL_RenderCopy(Rend, Tex, &Source, &ITarget);
+#endif
+				SDL_SetTextureColorMod(Tex, tr, tg, tb);
+				SDL_SetTextureAlphaMod(Tex, ta);
+				SDL_SetTextureBlendMode(Tex, tm);
+			}
+			SDL_RenderReadPixels(Rend, NULL, SDL_PIXELFORMAT_ARGB8888, Surf->pixels, Surf->pitch);
+			SDL_SetRenderDrawColor(Rend, cr, cg, cb, ca);
+			SDL_SetRenderTarget(Rend, OldTarget);
+			ApplyAltScale(); // Before the viewport, as that one is relative to the scale
+			SDL_RenderSetViewport(Rend, &VP);
+			SDL_RenderSetClipRect(Rend, ClipEnabled ? &Clip : NULL);
+			SDL_DestroyTexture(Canvas);
+			auto ret{ SDL_CreateColorCursor(Surf, hx, hy) };
+			if (!ret) _LastError = TrSPrintF("ImageCursor(): %s", SDL_GetError());
+			SDL_FreeSurface(Surf);
+			return ret;
+		}
+
+		bool ImageCursor(TImage Img, int frame) {
+			_LastError = "";
+			if (!NeedScreen()) return false;
+			if (!Img || !Img->Valid() || frame < 0 || frame >= (int)Img->Frames()) {
+				_LastError = "ImageCursor(): No such image or frame"; // Images drawn by a TQAltPic driver have no textures to take the cursor from either
+				return false;
+			}
+			int
+				iw{ Img->Width() },
+				ih{ Img->Height() };
+			if (iw <= 0 || ih <= 0) {
+				_LastError = "ImageCursor(): Image has no size";
+				return false;
+			}
+			// The cursor isn't drawn by the renderer, so the alt screen (GPU or not) must be put in the picture itself
+			int
+				w{ std::max(1, AltScreen.TrueW(iw)) },
+				h{ std::max(1, AltScreen.TrueH(ih)) };
+			auto Key{ std::make_tuple(Img.get(), frame, w, h) };
+			auto Found{ _Cursors.find(Key) };
+			SDL_Cursor* C{ nullptr };
+			if (Found != _Cursors.end()) C = Found->second.Cursor; else {
+				int
+					hx{ std::min(w - 1, std::max(0, (int)round((double)Img->HotX() * w / iw))) },
+					hy{ std::min(h - 1, std::max(0, (int)round((double)Img->HotY() * h / ih))) };
+				C = MakeCursor(Img, frame, w, h, hx, hy);
+				if (!C) return false;
+				_Cursors[Key] = { Img, C };
+			}
+			if (C != _CurrentCursor) {
+				SDL_SetCursor(C);
+				_CurrentCursor = C;
+			}
+			SDL_ShowCursor(SDL_ENABLE);
+			return true;
+		}
+
+		void DefaultCursor() {
+			SDL_SetCursor(SDL_GetDefaultCursor());
+			_CurrentCursor = nullptr;
+		}
+
+		void ClearCursorCache() {
+			DefaultCursor();
+			for (auto& C : _Cursors) SDL_FreeCursor(C.second.Cursor);
+			_Cursors.clear();
+		}
 #pragma endregion
 
 #pragma region TQAltPic
@@ -573,6 +1975,296 @@ namespace Slyvina {
 		}
 #pragma endregion
 
+#pragma region ImagePreprocess
+		static bool
+			_LoadTrim{ false },
+			_LoadOpaque{ false },
+			_Prescale{ false };
+		static double
+			_PrescaleFactor{ 0 };
+
+		void ImageLoadTrim(bool on) { _LoadTrim = on; }
+		bool ImageLoadTrim() { return _LoadTrim; }
+		void ImageLoadOpaque(bool on) { _LoadOpaque = on; }
+		bool ImageLoadOpaque() { return _LoadOpaque; }
+		void ImagePrescale(bool on, double Factor) { _Prescale = on; _PrescaleFactor = std::max(0.0, Factor); }
+		bool ImagePrescale() { return _Prescale; }
+
+		// Row of ARGB8888 pixels. Returns true when any pixel is not fully transparent. Opaque is cleared when any pixel is not fully opaque.
+		static bool ScanAlphaRow(const uint32* Row, int w, bool& Opaque) {
+			int i{ 0 };
+			uint32
+				Any{ 0 },
+				All{ 0xff000000 };
+#ifdef TQSG_SSE2
+			const __m128i Mask{ _mm_set1_epi32((int)0xff000000) };
+			__m128i
+				VAny{ _mm_setzero_si128() },
+				VAll{ Mask };
+			for (; i + 4 <= w; i += 4) {
+				auto A{ _mm_and_si128(_mm_loadu_si128((const __m128i*)(Row + i)), Mask) };
+				VAny = _mm_or_si128(VAny, A);
+				VAll = _mm_and_si128(VAll, A);
+			}
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(VAny, _mm_setzero_si128())) != 0xffff) Any = 0xff000000;
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(VAll, Mask)) != 0xffff) All = 0;
+#endif
+			for (; i < w; i++) {
+				Any |= Row[i];
+				All &= Row[i];
+			}
+			if ((All & 0xff000000) != 0xff000000) Opaque = false;
+			return (Any & 0xff000000) != 0;
+		}
+
+		// The copies are made with premultiplied alpha, or else transparent pixels (which are often black) would darken the edges
+		static void Premultiply(uint32* P, size_t n) {
+			for (size_t i = 0; i < n; i++) {
+				uint32
+					a{ P[i] >> 24 },
+					r{ (P[i] >> 16) & 255 },
+					g{ (P[i] >> 8) & 255 },
+					b{ P[i] & 255 };
+				P[i] = (a << 24) | (((r * a + 127) / 255) << 16) | (((g * a + 127) / 255) << 8) | ((b * a + 127) / 255);
+			}
+		}
+
+		static void Unpremultiply(const uint32* P, uint32* Out, size_t n) {
+			for (size_t i = 0; i < n; i++) {
+				uint32 a{ P[i] >> 24 };
+				if (!a) { Out[i] = 0; continue; }
+				uint32
+					r{ std::min(255u, ((((P[i] >> 16) & 255) * 255) + (a / 2)) / a) },
+					g{ std::min(255u, ((((P[i] >> 8) & 255) * 255) + (a / 2)) / a) },
+					b{ std::min(255u, (((P[i] & 255) * 255) + (a / 2)) / a) };
+				Out[i] = (a << 24) | (r << 16) | (g << 8) | b;
+			}
+		}
+
+		static inline uint32 Avg2(uint32 a, uint32 b) { return (a | b) - (((a ^ b) >> 1) & 0x7f7f7f7f); } // Per byte (a+b+1)/2, the same as _mm_avg_epu8
+
+		// Rows y1 to y2 of a picture half the size of Src (rounded up). Odd edges just repeat their last pixel.
+		static void HalveRows(const uint32* Src, int sw, int sh, uint32* Dst, int dw, int y1, int y2) {
+			for (int y = y1; y < y2; y++) {
+				auto
+					RowA{ Src + ((size_t)std::min(y * 2, sh - 1) * sw) },
+					RowB{ Src + ((size_t)std::min((y * 2) + 1, sh - 1) * sw) };
+				auto Out{ Dst + ((size_t)y * dw) };
+				int x{ 0 };
+#ifdef TQSG_SSE2
+				for (; (x + 4) * 2 <= sw; x += 4) {
+					auto
+						V0{ _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(RowA + (x * 2))), _mm_loadu_si128((const __m128i*)(RowB + (x * 2)))) },
+						V1{ _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(RowA + (x * 2) + 4)), _mm_loadu_si128((const __m128i*)(RowB + (x * 2) + 4))) },
+						Even{ _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(V0), _mm_castsi128_ps(V1), _MM_SHUFFLE(2, 0, 2, 0))) },
+						Odd{ _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(V0), _mm_castsi128_ps(V1), _MM_SHUFFLE(3, 1, 3, 1))) };
+					_mm_storeu_si128((__m128i*)(Out + x), _mm_avg_epu8(Even, Odd));
+				}
+#endif
+				for (; x < dw; x++) {
+					int
+						x1{ std::min(x * 2, sw - 1) },
+						x2{ std::min((x * 2) + 1, sw - 1) };
+					Out[x] = Avg2(Avg2(RowA[x1], RowB[x1]), Avg2(RowA[x2], RowB[x2]));
+				}
+			}
+		}
+
+		// Makes the prescaled copies of a picture. The caller must free the surfaces.
+		static std::vector<SDL_Surface*> Prescaled(SDL_Surface* Src) {
+			std::vector<SDL_Surface*> ret{};
+			double Factor{ _PrescaleFactor };
+			if (Factor <= 0) {
+				double
+					rx{ AltScreen.GetW() > 0 ? AltScreen.TrueRX() : 1 },
+					ry{ AltScreen.GetH() > 0 ? AltScreen.TrueRY() : 1 };
+				Factor = std::max(rx * std::abs(_scalex), ry * std::abs(_scaley));
+			}
+			if (Factor <= 0 || Factor > 0.5) return ret; // Nothing will be drawn at half the size or less, so no need for copies
+			int Levels{ std::min(8, (int)floor(log2(1 / Factor) + 0.000001)) };
+			int
+				sw{ Src->w },
+				sh{ Src->h };
+			std::vector<uint32>
+				Cur((size_t)sw * sh),
+				Next{},
+				Out{};
+			SDL_LockSurface(Src);
+			for (int y = 0; y < sh; y++) memcpy(Cur.data() + ((size_t)y * sw), (const byte*)Src->pixels + ((size_t)y * Src->pitch), (size_t)sw * 4);
+			SDL_UnlockSurface(Src);
+			Premultiply(Cur.data(), Cur.size());
+			for (int l = 0; l < Levels && (sw > 1 || sh > 1); l++) {
+				int
+					dw{ (sw + 1) / 2 },
+					dh{ (sh + 1) / 2 };
+				Next.resize((size_t)dw * dh);
+				// Big pictures are split over the worker threads
+				int
+					Parts{ (dw * dh >= 256 * 256) ? (int)std::max(1u, std::thread::hardware_concurrency()) : 1 },
+					chunk{ (dh / Parts) + 1 };
+				ParallelRun((size_t)Parts, [&](size_t p) {
+					int y{ (int)p * chunk };
+					if (y < dh) HalveRows(Cur.data(), sw, sh, Next.data(), dw, y, std::min(y + chunk, dh));
+					});
+				Cur.swap(Next);
+				sw = dw;
+				sh = dh;
+				auto Surf{ SDL_CreateRGBSurfaceWithFormat(0, sw, sh, 32, SDL_PIXELFORMAT_ARGB8888) };
+				if (!Surf) break;
+				Out.resize(Cur.size());
+				Unpremultiply(Cur.data(), Out.data(), Out.size());
+				SDL_LockSurface(Surf);
+				for (int y = 0; y < sh; y++) memcpy((byte*)Surf->pixels + ((size_t)y * Surf->pitch), Out.data() + ((size_t)y * sw), (size_t)sw * 4);
+				SDL_UnlockSurface(Surf);
+				ret.push_back(Surf);
+			}
+			return ret;
+		}
+
+		// Scans the decoded surface, cuts off the transparent borders when wanted and turns it into a texture.
+		SDL_Texture* _____TIMAGE::Prepare(SDL_Surface* Surf, __FrameInfo& Info) {
+			Info = __FrameInfo{ { 0,0,Surf->w,Surf->h }, Surf->w, Surf->h, false, false };
+			SDL_Surface
+				* Conv{ nullptr },
+				* Cut{ nullptr };
+			if (_LoadTrim || _LoadOpaque) {
+				if (!SDL_ISPIXELFORMAT_ALPHA(Surf->format->format) && !SDL_ISPIXELFORMAT_INDEXED(Surf->format->format) && SDL_GetColorKey(Surf, NULL) != 0)
+					Info.Opaque = _LoadOpaque; // Nothing in there can be transparent
+				else
+					Conv = SDL_ConvertSurfaceFormat(Surf, SDL_PIXELFORMAT_ARGB8888, 0); // Color keys become alpha here, just like they do in SDL_CreateTextureFromSurface
+			}
+			if (Conv) {
+				int
+					x1{ Conv->w },
+					x2{ -1 },
+					y1{ Conv->h },
+					y2{ -1 };
+				bool Opaque{ true };
+				SDL_LockSurface(Conv);
+				for (int y = 0; y < Conv->h; y++) {
+					auto Row{ (const uint32*)((const byte*)Conv->pixels + ((size_t)y * Conv->pitch)) };
+					if (!ScanAlphaRow(Row, Conv->w, Opaque)) continue;
+					y1 = std::min(y1, y);
+					y2 = y;
+					for (int x = 0; x < x1; x++) if (Row[x] & 0xff000000) { x1 = x; break; }
+					for (int x = Conv->w - 1; x > x2; x--) if (Row[x] & 0xff000000) { x2 = x; break; }
+				}
+				SDL_UnlockSurface(Conv);
+				Info.Opaque = _LoadOpaque && Opaque;
+				if (_LoadTrim && !Opaque) {
+					if (y2 < 0) Info.Area = { 0,0,1,1 }; // Nothing to see at all, but a frame still needs a texture
+					else Info.Area = { x1, y1, (x2 - x1) + 1, (y2 - y1) + 1 };
+					Info.Trimmed = Info.Area.w < Conv->w || Info.Area.h < Conv->h;
+				}
+				if (Info.Trimmed) Cut = SDL_CreateRGBSurfaceWithFormatFrom(
+					(byte*)Conv->pixels + ((size_t)Info.Area.y * Conv->pitch) + ((size_t)Info.Area.x * 4),
+					Info.Area.w, Info.Area.h, 32, Conv->pitch, SDL_PIXELFORMAT_ARGB8888);
+				if (Info.Trimmed && !Cut) Info = __FrameInfo{ { 0,0,Surf->w,Surf->h }, Surf->w, Surf->h, false, Info.Opaque }; // Just use the full picture then
+			}
+			std::vector<SDL_Surface*> Copies{};
+			if (_Prescale) {
+				if (!Conv) Conv = SDL_ConvertSurfaceFormat(Surf, SDL_PIXELFORMAT_ARGB8888, 0);
+				if (Conv) Copies = Prescaled(Cut ? Cut : Conv);
+			}
+			SDL_Texture* ret{ nullptr };
+			{
+				__RenderLock Lock(_RenderMutex);
+				ret = SDL_CreateTextureFromSurface(_Screen->gRenderer, Cut ? Cut : Surf);
+				for (auto C : Copies) {
+					auto Tex{ ret ? SDL_CreateTextureFromSurface(_Screen->gRenderer, C) : nullptr };
+					if (Tex) Info.Variants.push_back({ Tex, C->w, C->h });
+					SDL_FreeSurface(C);
+				}
+			}
+			if (Cut) SDL_FreeSurface(Cut);
+			if (Conv) SDL_FreeSurface(Conv);
+			return ret;
+		}
+
+		bool _____TIMAGE::TrimRect(size_t frame, SDL_FRect& Target, SDL_Rect& Source, SDL_FPoint* Center, int Flip, const SDL_Rect* Part) {
+			if (!Trimmed(frame)) {
+				if (Part) Source = *Part;
+				else {
+					Source = { 0,0,0,0 };
+					if (frame < Textures.size()) SDL_QueryTexture(Textures[frame], NULL, NULL, &Source.w, &Source.h);
+				}
+				return true;
+			}
+			auto& FI{ FrameInfo[frame] };
+			SDL_Rect
+				P{ Part ? *Part : SDL_Rect{ 0,0,FI.FullW,FI.FullH } },
+				Cut;
+			if (P.w <= 0 || P.h <= 0 || !SDL_IntersectRect(&P, &FI.Area, &Cut)) return false;
+			// Flipping mirrors the part within the target, so the cut off borders swap sides as well
+			float
+				fx{ Target.w / P.w },
+				fy{ Target.h / P.h },
+				dx{ (float)((Flip & SDL_FLIP_HORIZONTAL) ? (P.x + P.w) - (Cut.x + Cut.w) : Cut.x - P.x) * fx },
+				dy{ (float)((Flip & SDL_FLIP_VERTICAL) ? (P.y + P.h) - (Cut.y + Cut.h) : Cut.y - P.y) * fy };
+			Target = { Target.x + dx, Target.y + dy, Cut.w * fx, Cut.h * fy };
+			if (Center) {
+				// The rotation must still happen around the same spot
+				Center->x -= dx;
+				Center->y -= dy;
+			}
+			Source = { Cut.x - FI.Area.x, Cut.y - FI.Area.y, Cut.w, Cut.h };
+			return true;
+		}
+
+		SDL_Texture* _____TIMAGE::MapFrame(size_t frame, SDL_FRect& Target, SDL_Rect& Source, SDL_FPoint* Center, int Flip, const SDL_Rect* Part) {
+			if (frame >= Textures.size() || !TrimRect(frame, Target, Source, Center, Flip, Part)) return nullptr;
+			if (frame >= FrameInfo.size() || !FrameInfo[frame].Variants.size() || Source.w <= 0 || Source.h <= 0) return Textures[frame];
+			auto& FI{ FrameInfo[frame] };
+			// The smallest copy that still has at least one pixel for every pixel on the screen
+			double
+				rx{ std::abs(Target.w) * _GPUScaleX / Source.w },
+				ry{ std::abs(Target.h) * _GPUScaleY / Source.h };
+			int Pick{ -1 };
+			for (size_t i = 0; i < FI.Variants.size(); i++) {
+				auto& V{ FI.Variants[i] };
+				if ((double)V.W / FI.Area.w < rx || (double)V.H / FI.Area.h < ry) break;
+				Pick = (int)i;
+			}
+			if (Pick < 0) return Textures[frame];
+			auto& V{ FI.Variants[Pick] };
+			double
+				fx{ (double)V.W / FI.Area.w },
+				fy{ (double)V.H / FI.Area.h };
+			int
+				x1{ (int)round(Source.x * fx) },
+				y1{ (int)round(Source.y * fy) },
+				x2{ (int)round((Source.x + Source.w) * fx) },
+				y2{ (int)round((Source.y + Source.h) * fy) };
+			Source = { x1, y1, std::max(1, x2 - x1), std::max(1, y2 - y1) };
+			return V.Tex;
+		}
+
+		void _____TIMAGE::CopyFrame(size_t frame, const SDL_Rect* Part, SDL_FRect Target, const TDrawState& State, double angle, SDL_FPoint center, int flip) {
+			SDL_Rect Source;
+			auto Tex{ MapFrame(frame, Target, Source, &center, flip, Part) };
+			if (!Tex) return;
+			if (Tex != Textures[frame]) {
+				// The caller only set these for the frame itself
+				SDL_SetTextureBlendMode(Tex, (SDL_BlendMode)FrameBlend(frame, State));
+				SDL_SetTextureAlphaMod(Tex, State.alpha);
+				SDL_SetTextureColorMod(Tex, State.r, State.g, State.b);
+			}
+#if SDL_VERSION_ATLEAST(2,0,10)
+			SDL_RenderCopyExF(_Screen->gRenderer, Tex, &Source, &Target, angle, &center, (SDL_RendererFlip)flip);
+#else
+			SDL_Rect ITarget{ (int)floor(Target.x), (int)floor(Target.y), (int)ceil(Target.w), (int)ceil(Target.h) };
+			SDL_Point ICenter{ (int)center.x, (int)center.y };
+			SDL_RenderCopyEx(_Screen->gRenderer, Tex, &Source, &ITarget, angle, &ICenter, (SDL_RendererFlip)flip);
+#endif
+		}
+
+		Blend _____TIMAGE::FrameBlend(size_t frame, const TDrawState& State) {
+			return (State.blend == Blend::ALPHA && State.alpha == 255 && Opaque(frame)) ? Blend::NONE : State.blend;
+		}
+
+		static inline SDL_FRect FRect(const SDL_Rect& R) { return { (float)R.x, (float)R.y, (float)R.w, (float)R.h }; }
+#pragma endregion
+
 #pragma region TImage
 
 		SDL_Texture* _____TIMAGE::GetFrame(size_t frame) {
@@ -581,8 +2273,11 @@ namespace Slyvina {
 		}
 
 		void _____TIMAGE::KillAllFrames() {
+			__RenderLock Lock(_RenderMutex);
 			for (auto T : Textures) SDL_DestroyTexture(T);
+			for (auto& FI : FrameInfo) for (auto& V : FI.Variants) SDL_DestroyTexture(V.Tex);
 			Textures.clear();
+			FrameInfo.clear();
 		}
 
 		void _____TIMAGE::LoadFrame(size_t frame, SDL_RWops* data, bool autofree) {
@@ -595,26 +2290,46 @@ namespace Slyvina {
 				return;
 			}
 			if (!NeedScreen()) return;
-			auto buf = IMG_LoadTexture_RW(_Screen->gRenderer, data, autofree);
-
+			auto surf{ IMG_Load_RW(data, autofree) };
+			if (surf == NULL) { Paniek("Getting texture from SDL_RWops failed!"); return; }
+			__FrameInfo Info;
+			auto buf{ Prepare(surf, Info) };
+			SDL_FreeSurface(surf);
 			if (buf == NULL) { Paniek("Getting texture from SDL_RWops failed!"); return; }
+			__RenderLock Lock(_RenderMutex);
+			FrameInfo.resize(Textures.size());
+			if (Textures[frame]) SDL_DestroyTexture(Textures[frame]); // The frame that is replaced, with its variants
+			for (auto& V : FrameInfo[frame].Variants) SDL_DestroyTexture(V.Tex);
 			Textures[frame] = buf;
+			FrameInfo[frame] = Info;
 		}
 		void _____TIMAGE::LoadFrame(SDL_RWops* data, bool autofree) {
 			_LastError = "";
 			if (!NeedScreen()) return;
-			auto buf = IMG_LoadTexture_RW(_Screen->gRenderer, data, autofree);
+			auto surf{ IMG_Load_RW(data, autofree) };
+			if (surf == NULL) { Paniek("Getting texture from SDL_RWops failed!"); return; }
+			__FrameInfo Info;
+			auto buf{ Prepare(surf, Info) };
+			SDL_FreeSurface(surf);
 			if (buf == NULL) { Paniek("Getting texture from SDL_RWops failed!"); return; }
+			FrameInfo.resize(Textures.size());
 			Textures.push_back(buf);
+			FrameInfo.push_back(Info);
 		}
 
 		void _____TIMAGE::Blit(int ax, int ay, int isx, int isy, int iex, int iey, int frame) {
 			if (!NeedScreen()) return;
+			if (std::min(iex, Width() - isx) < 1 || std::min(iey, Height() - isy) < 1) { _LastError = "Blit format error"; return; }
+			Blit(ax, ay, isx, isy, iex, iey, frame, CurrentState());
+		}
+
+		void _____TIMAGE::Blit(int ax, int ay, int isx, int isy, int iex, int iey, int frame, const TDrawState& State) {
+			if (!_Screen || frame < 0 || frame >= Textures.size()) return;
 			auto
-				x = ax + _originx,
-				y = ay + _originy,
-				imgh = Height(),
-				imgw = Width();
+				x = ax + State.originx,
+				y = ay + State.originy,
+				imgh = RawHeight(),
+				imgw = RawWidth();
 			SDL_Rect
 				Target,
 				Source;
@@ -626,7 +2341,7 @@ namespace Slyvina {
 			Source.y = std::max(isy, 0);
 			Source.w = std::min(iex, imgw - isx);
 			Source.h = std::min(iey, imgh - isy);
-			if (Source.w < 1 || Source.h < 1) { _LastError = "Blit format error"; return; }
+			if (Source.w < 1 || Source.h < 1) return;
 			/*
 			Target.x = x;
 			Target.y = y;
@@ -635,12 +2350,14 @@ namespace Slyvina {
 			//*/
 			Target.x = AltScreen.X(x);
 			Target.y = AltScreen.Y(y);
-			Target.w = AltScreen.ScaledW(Source.w);
-			Target.h = AltScreen.ScaledW(Source.h);
-			SDL_SetTextureColorMod(Textures[frame], _red, _green, _blue);
-			SDL_SetTextureBlendMode(Textures[frame], (SDL_BlendMode)_blend);
-			SDL_SetTextureAlphaMod(Textures[frame], _alpha);
-			SDL_RenderCopy(_Screen->gRenderer, Textures[frame], &Source, &Target);
+			Target.w = (int)ceil(AltScreen.W(Source.w) * State.scalex);
+			Target.h = (int)ceil(AltScreen.W(Source.h) * State.scalex);
+			if (Culled(Target)) return;
+			SDL_SetTextureColorMod(Textures[frame], State.r, State.g, State.b);
+			SDL_SetTextureBlendMode(Textures[frame], (SDL_BlendMode)FrameBlend(frame, State));
+			SDL_SetTextureAlphaMod(Textures[frame], State.alpha);
+			if (Mapped(frame)) CopyFrame(frame, &Source, FRect(Target), State);
+			else SDL_RenderCopy(_Screen->gRenderer, Textures[frame], &Source, &Target);
 		}
 		void _____TIMAGE::Blit(int ax, int ay, int w, int h, int isx, int isy, int iex, int iey, int frame) {
 			if (!NeedScreen()) return;
@@ -665,11 +2382,33 @@ namespace Slyvina {
 			Target.y = AltScreen.Y(y);
 			Target.w = AltScreen.W(w);
 			Target.h = AltScreen.H(h);
+			if (Culled(Target)) return;
+			auto State{ CurrentState() };
 			SDL_SetTextureColorMod(Textures[frame], _red, _green, _blue);
-			SDL_SetTextureBlendMode(Textures[frame], (SDL_BlendMode)_blend);
+			SDL_SetTextureBlendMode(Textures[frame], (SDL_BlendMode)FrameBlend(frame, State));
 			SDL_SetTextureAlphaMod(Textures[frame], _alpha);
-			SDL_RenderCopy(_Screen->gRenderer, Textures[frame], &Source, &Target);
+			if (Mapped(frame)) CopyFrame(frame, &Source, FRect(Target), State);
+			else SDL_RenderCopy(_Screen->gRenderer, Textures[frame], &Source, &Target);
+
+		}
+
+		// Width() and Height() without touching LastError()
+		int _____TIMAGE::RawWidth() {
+			if (AltPic && AltPic->Width) return AltPic->Width(this);
+			if (!Textures.size()) return 0;
+			if (Trimmed(0)) return FrameInfo[0].FullW;
+			int w, h;
+			SDL_QueryTexture(Textures[0], NULL, NULL, &w, &h);
+			return w;
+		}
 
+		int _____TIMAGE::RawHeight() {
+			if (AltPic && AltPic->Height) return AltPic->Height(this);
+			if (!Textures.size()) return 0;
+			if (Trimmed(0)) return FrameInfo[0].FullH;
+			int w, h;
+			SDL_QueryTexture(Textures[0], NULL, NULL, &w, &h);
+			return h;
 		}
 
 		int _____TIMAGE::Width() {
@@ -679,9 +2418,7 @@ namespace Slyvina {
 				_LastError = "<Image>->Width(): No Frames";
 				return 0;
 			}
-			int w, h;
-			SDL_QueryTexture(Textures[0], NULL, NULL, &w, &h);
-			return w;
+			return RawWidth();
 		}
 
 		int _____TIMAGE::Height() {
@@ -691,9 +2428,7 @@ namespace Slyvina {
 				_LastError = "<Image>->Height(): No Frames";
 				return 0;
 			}
-			int w, h;
-			SDL_QueryTexture(Textures[0], NULL, NULL, &w, &h);
-			return h;
+			return RawHeight();
 		}
 
 		void _____TIMAGE::GetFormat(int* width, int* height) {
@@ -703,6 +2438,11 @@ namespace Slyvina {
 				_LastError = "<Image>->Height(): No Frames";
 				return;
 			}
+			if (Trimmed(0)) {
+				if (width) *width = FrameInfo[0].FullW;
+				if (height) *height = FrameInfo[0].FullH;
+				return;
+			}
 			SDL_QueryTexture(Textures[0], NULL, NULL, width, height);
 		}
 
@@ -744,7 +2484,9 @@ namespace Slyvina {
 					return;
 				}
 				//Create texture from surface pixels
-				auto newTexture = SDL_CreateTextureFromSurface(_Screen->gRenderer, surf);
+				__FrameInfo Info;
+				auto newTexture = Prepare(surf, Info);
+				SDL_FreeSurface(surf);
 				if (newTexture == NULL) {
 					//char FE[300];
 					//sprintf_s(FE, 295, "Unable to create texture from %s!\nSDL Error: %s", file.c_str(), SDL_GetError());
@@ -752,7 +2494,9 @@ namespace Slyvina {
 					_LastError = TrSPrintF("Unable to create texture from %s!\nSDL Error: ", file.c_str()) + SDL_GetError();
 					return;
 				}
+				FrameInfo.resize(Textures.size());
 				Textures.push_back(newTexture);
+				FrameInfo.push_back(Info);
 			}
 		}
 
@@ -844,15 +2588,22 @@ namespace Slyvina {
 				_LastError = TrSPrintF("Texture assignment out of bouds! (%d/%d)", frame, (int)Textures.size());
 				return;
 			}
+			StretchDraw(x, y, w, h, frame, CurrentState());
+		}
+
+		void _____TIMAGE::StretchDraw(int x, int y, int w, int h, int frame, const TDrawState& State) {
+			if (!_Screen || frame < 0 || frame >= Textures.size()) return;
 			SDL_Rect Target;
-			Target.x = AltScreen.X(x + _originx);
-			Target.y = AltScreen.Y(y + _originy);
+			Target.x = AltScreen.X(x + State.originx);
+			Target.y = AltScreen.Y(y + State.originy);
 			Target.w = AltScreen.W(w);
 			Target.h = AltScreen.H(h);
-			SDL_SetTextureBlendMode(Textures[frame], SDLBlend());
-			SDL_SetTextureAlphaMod(Textures[frame], _alpha);
-			SDL_SetTextureColorMod(Textures[frame], _red, _green, _blue);
-			SDL_RenderCopy(_Screen->gRenderer, Textures[frame], NULL, &Target);
+			if (Culled(Target)) return;
+			SDL_SetTextureBlendMode(Textures[frame], (SDL_BlendMode)FrameBlend(frame, State));
+			SDL_SetTextureAlphaMod(Textures[frame], State.alpha);
+			SDL_SetTextureColorMod(Textures[frame], State.r, State.g, State.b);
+			if (Mapped(frame)) CopyFrame(frame, NULL, FRect(Target), State);
+			else SDL_RenderCopy(_Screen->gRenderer, Textures[frame], NULL, &Target);
 		}
 
 		void _____TIMAGE::Draw(int x, int y, int frame) {
@@ -868,16 +2619,25 @@ namespace Slyvina {
 				Paniek(FE);
 				return;
 			}
+			Draw(x, y, frame, CurrentState());
+		}
+
+		void _____TIMAGE::Draw(int x, int y, int frame, const TDrawState& State) {
+			if (!_Screen) return;
+			if (AltPic && AltPic->Draw) { AltPic->Draw(this, x, y, frame); return; }
+			if (frame < 0 || frame >= Textures.size()) return;
 			//std::cout << "...\n";
 			SDL_Rect Target;
-			Target.x = AltScreen.X((x - (int)ceil(hotx * _scalex)) + _originx);
-			Target.y = AltScreen.Y((y - (int)ceil(hoty * _scaley)) + _originy);
-			Target.w = AltScreen.W((int)ceil(Width() * _scalex));
-			Target.h = AltScreen.H((int)ceil(Height() * _scaley));
-			SDL_SetTextureBlendMode(Textures[frame], SDLBlend());
-			SDL_SetTextureAlphaMod(Textures[frame], _alpha);
-			SDL_SetTextureColorMod(Textures[frame], _red, _green, _blue);
-			SDL_RenderCopy(_Screen->gRenderer, Textures[frame], NULL, &Target);
+			Target.x = AltScreen.X((x - (int)ceil(hotx * State.scalex)) + State.originx);
+			Target.y = AltScreen.Y((y - (int)ceil(hoty * State.scaley)) + State.originy);
+			Target.w = AltScreen.W((int)ceil(RawWidth() * State.scalex));
+			Target.h = AltScreen.H((int)ceil(RawHeight() * State.scaley));
+			if (Culled(Target)) return;
+			SDL_SetTextureBlendMode(Textures[frame], (SDL_BlendMode)FrameBlend(frame, State));
+			SDL_SetTextureAlphaMod(Textures[frame], State.alpha);
+			SDL_SetTextureColorMod(Textures[frame], State.r, State.g, State.b);
+			if (Mapped(frame)) CopyFrame(frame, NULL, FRect(Target), State);
+			else SDL_RenderCopy(_Screen->gRenderer, Textures[frame], NULL, &Target);
 		}
 
 		void _____TIMAGE::TrueDraw(int x, int y, int frame) {
@@ -893,22 +2653,23 @@ namespace Slyvina {
 				Paniek(TrSPrintF("DRAW:Texture frame assignment out of bouds! (%d/%d/R)", frame, (int)Textures.size()));
 				return;
 			}
+			__TrueCoords TC;
 			SDL_Rect Target;
 			Target.x = x - hotx; //+_originx;
 			Target.y = y - hoty; //+_originy;
 			Target.w = Width();
 			Target.h = Height();
-			SDL_SetTextureBlendMode(Textures[frame], SDLBlend());
+			if (Culled(Target)) return;
+			auto State{ CurrentState() };
+			SDL_SetTextureBlendMode(Textures[frame], (SDL_BlendMode)FrameBlend(frame, State));
 			SDL_SetTextureAlphaMod(Textures[frame], _alpha);
 			SDL_SetTextureColorMod(Textures[frame], _red, _green, _blue);
-			SDL_RenderCopy(_Screen->gRenderer, Textures[frame], NULL, &Target);
+			if (Mapped(frame)) CopyFrame(frame, NULL, FRect(Target), State);
+			else SDL_RenderCopy(_Screen->gRenderer, Textures[frame], NULL, &Target);
 		}
 
 		void _____TIMAGE::XDraw(int x, int y, int frame) {
 			if (!NeedScreen()) return;
-			int limgflip{ SDL_FLIP_NONE };
-			auto _scalex{ TQSG::_scalex };
-			auto _scaley{ TQSG::_scaley };
 			_LastError = "";
 			if (frame < 0 || frame >= Textures.size()) {
 				/* Old code, and gcc doesn't like sprintf_s
@@ -920,6 +2681,14 @@ namespace Slyvina {
 				Paniek(FE);
 				return;
 			}
+			XDraw(x, y, frame, CurrentState());
+		}
+
+		void _____TIMAGE::XDraw(int x, int y, int frame, const TDrawState& State) {
+			if (!_Screen || frame < 0 || frame >= Textures.size()) return;
+			int limgflip{ SDL_FLIP_NONE };
+			auto _scalex{ State.scalex };
+			auto _scaley{ State.scaley };
 			if (_scalex < 0) {
 				_scalex = abs(_scalex);
 				limgflip |= SDL_FLIP_HORIZONTAL;
@@ -930,35 +2699,113 @@ namespace Slyvina {
 			}
 			//*
 				SDL_Rect Target{
-					AltScreen.X((x - (hotx * _scalex)) + _originx),
-					AltScreen.Y((y - (hoty * _scaley)) + _originy),
-					AltScreen.W((int)(Width() * _scalex)),
-					AltScreen.H((int)(Height() * _scaley))
+					AltScreen.X((x - (hotx * _scalex)) + State.originx),
+					AltScreen.Y((y - (hoty * _scaley)) + State.originy),
+					AltScreen.W((int)(RawWidth() * _scalex)),
+					AltScreen.H((int)(RawHeight() * _scaley))
 			};
 
 			SDL_Point cpoint{ (int)(hotx * _scalex * AltScreen.RX()),(int)(hoty * _scaley * AltScreen.RY()) };
+			if (Culled((float)Target.x, (float)Target.y, (float)Target.w, (float)Target.h, State.rotatedeg, (float)cpoint.x, (float)cpoint.y)) return;
 
 			//SDL_RenderCopy(gRenderer, Textures[frame], NULL, &Target);
-				SDL_SetTextureBlendMode(Textures[frame], SDLBlend());
-				SDL_SetTextureAlphaMod(Textures[frame], _alpha);
-				SDL_SetTextureColorMod(Textures[frame], _red, _green, _blue);
-				SDL_RenderCopyEx(_Screen->gRenderer, Textures[frame], NULL, &Target, _rotatedeg, &cpoint, (SDL_RendererFlip)limgflip);
+				SDL_SetTextureBlendMode(Textures[frame], (SDL_BlendMode)FrameBlend(frame, State));
+				SDL_SetTextureAlphaMod(Textures[frame], State.alpha);
+				SDL_SetTextureColorMod(Textures[frame], State.r, State.g, State.b);
+				if (Mapped(frame)) CopyFrame(frame, NULL, FRect(Target), State, State.rotatedeg, { (float)cpoint.x, (float)cpoint.y }, limgflip);
+				else SDL_RenderCopyEx(_Screen->gRenderer, Textures[frame], NULL, &Target, State.rotatedeg, &cpoint, (SDL_RendererFlip)limgflip);
 
 		}
 
+		void _____TIMAGE::BatchDraw(TQuadBatch& Batch, int x, int y, int frame) {
+			_LastError = "";
+			if (!NeedScreen()) return;
+			if (AltPic && AltPic->Draw) { Batch.Flush(); AltPic->Draw(this, x, y, frame); return; }
+			if (frame < 0 || frame >= Textures.size()) {
+				Paniek(TrSPrintF("BATCHDRAW:Texture frame assignment out of bouds! (%d/%d/R)", frame, (int)Textures.size()));
+				return;
+			}
+			BatchDraw(Batch, x, y, frame, CurrentState());
+		}
+
+		void _____TIMAGE::BatchDraw(TQuadBatch& Batch, int x, int y, int frame, const TDrawState& State) {
+			if (!_Screen) return;
+			if (AltPic && AltPic->Draw) { Batch.Flush(); AltPic->Draw(this, x, y, frame); return; }
+			if (frame < 0 || frame >= Textures.size()) return;
+			SDL_FRect Target{
+				(float)AltScreen.X((x - (int)ceil(hotx * State.scalex)) + State.originx),
+				(float)AltScreen.Y((y - (int)ceil(hoty * State.scaley)) + State.originy),
+				(float)AltScreen.W((int)ceil(RawWidth() * State.scalex)),
+				(float)AltScreen.H((int)ceil(RawHeight() * State.scaley))
+			};
+			if (Culled(Target.x, Target.y, Target.w, Target.h)) return;
+			SDL_Rect Source;
+			auto Tex{ Textures[frame] };
+			if (Mapped(frame) && !(Tex = MapFrame(frame, Target, Source))) return;
+			Batch.Start(Tex, FrameBlend(frame, State));
+			Batch.Add(Target, Mapped(frame) ? &Source : NULL, State.r, State.g, State.b, State.alpha);
+		}
+
+		void _____TIMAGE::BatchXDraw(TQuadBatch& Batch, int x, int y, int frame) {
+			_LastError = "";
+			if (!NeedScreen()) return;
+			if (frame < 0 || frame >= Textures.size()) {
+				Paniek(TrSPrintF("BATCHXDRAW:Texture frame assignment out of bouds! (%d/%d)", frame, (int)Textures.size()));
+				return;
+			}
+			BatchXDraw(Batch, x, y, frame, CurrentState());
+		}
+
+		void _____TIMAGE::BatchXDraw(TQuadBatch& Batch, int x, int y, int frame, const TDrawState& State) {
+			if (!_Screen || frame < 0 || frame >= Textures.size()) return;
+			int limgflip{ SDL_FLIP_NONE };
+			auto _scalex{ State.scalex };
+			auto _scaley{ State.scaley };
+			if (_scalex < 0) {
+				_scalex = abs(_scalex);
+				limgflip |= SDL_FLIP_HORIZONTAL;
+			}
+			if (_scaley < 0) {
+				_scaley = abs(_scaley);
+				limgflip |= SDL_FLIP_VERTICAL;
+			}
+			SDL_FRect Target{
+				(float)AltScreen.X((x - (hotx * _scalex)) + State.originx),
+				(float)AltScreen.Y((y - (hoty * _scaley)) + State.originy),
+				(float)AltScreen.W((int)(RawWidth() * _scalex)),
+				(float)AltScreen.H((int)(RawHeight() * _scaley))
+			};
+			SDL_FPoint cpoint{ (float)(int)(hotx * _scalex * AltScreen.RX()),(float)(int)(hoty * _scaley * AltScreen.RY()) };
+			if (Culled(Target.x, Target.y, Target.w, Target.h, State.rotatedeg, cpoint.x, cpoint.y)) return;
+			SDL_Rect Source;
+			auto Tex{ Textures[frame] };
+			if (Mapped(frame) && !(Tex = MapFrame(frame, Target, Source, &cpoint, limgflip))) return;
+			Batch.Start(Tex, FrameBlend(frame, State));
+			Batch.Add(Target, Mapped(frame) ? &Source : NULL, State.r, State.g, State.b, State.alpha, State.rotatedeg, cpoint, limgflip);
+		}
+
 		void _____TIMAGE::Tile(int ax, int ay, int w, int h, int frame, int aix, int aiy) {
 			using namespace std;
 			if (!NeedScreen()) return;
+			_LastError = "";
+			if (w <= 0 || h <= 0) return; // Nothing to do but getting bugged!
+			if (frame < 0 || frame >= Textures.size()) {
+				Paniek("<IMAGE>.Tile(" + to_string(ax) + "," + to_string(ay) + "," + to_string(w) + "," + to_string(h) + ") Frame(" + to_string(frame) + "/" + to_string(Frames()) + "): Out of frame boundaries (framecount: " + to_string(Textures.size()) + ")"); return;
+			}
+			Tile(ax, ay, w, h, frame, aix, aiy, CurrentState());
+		}
+
+		void _____TIMAGE::Tile(int ax, int ay, int w, int h, int frame, int aix, int aiy, const TDrawState& State) {
+			using namespace std;
+			if (!_Screen || frame < 0 || frame >= Textures.size()) return;
 			try {
 #ifdef TQSG_TileWithAltScreen
 				auto
-					x = ax + _originx,
-					y = ay + _originy,
+					x = ax + State.originx,
+					y = ay + State.originy,
 					ix = aix,
 					iy = aiy;
 
-
-				_LastError = "";
 				// todo: Fix issues with negative ix
 				/*???
 				if (iy>0)
@@ -974,7 +2821,7 @@ namespace Slyvina {
 					//cout << ix << "\n";
 
 					// Faulty: 	ix = (x - (Width() + ix)) % Width();
-					ix = Width() - (abs(ix) % Width());
+					ix = RawWidth() - (abs(ix) % RawWidth());
 				}
 				if (iy < 0) {
 					//cout << "neg x:" << ix << " to ";
@@ -982,13 +2829,13 @@ namespace Slyvina {
 					//cout << ix << "\n";
 
 					// Faulty: iy = (y - (Height() + iy)) % Height();
-					iy = Height() - (abs(iy) % Height());
+					iy = RawHeight() - (abs(iy) % RawHeight());
 				}
 				//int ox, oy, ow, oh;
 				//TQSG_GetViewPort(&ox, &oy, &ow, &oh);
 				int tsx, tsy, tex, tey, tw, th;
-				int imgh = Height();
-				int imgw = Width();
+				int imgh = RawHeight();
+				int imgw = RawWidth();
 				/*
 				tsx = max(ox, x);
 				tsy = max(oy, y);
@@ -1002,6 +2849,7 @@ namespace Slyvina {
 				tw = w;
 				th = h;
 				if (tw <= 0 || th <= 0) return; // Nothing to do but getting bugged!
+				if (Culled((float)AltScreen.X(tsx), (float)AltScreen.Y(tsy), (float)AltScreen.W(tw), (float)AltScreen.H(th))) return;
 				//cout << "TILE: Rect("<<x<<","<<y<<") "<<w<<"x"<<h<<" "<<"\n";
 				//cout << "\tViewPort(" << tsx << "," << tsy << "," << tw << "[" << tex << "]" << "," << th << "[" << tey << "])\n";
 				SDL_Rect Target, Source;
@@ -1010,10 +2858,10 @@ namespace Slyvina {
 				//cout << "for (int dy = tsy("<<tsy<<") - iy("<<iy<<")(" << (tsy - iy) << "); dy < tey(" << tey << "); dy += imgh(" << imgh << ")) \n";
 				//cout << "Color (" << (int)_red << "," << (int)_green << "," << (int)_blue << ")\n"; // DEBUG
 				//printf("TImage::Tile(%d,%d,%d,%d,%d,%d,%d):\n", ax, ay, w, h, frame, aix, aiy); // DEBUG
-				SDL_SetTextureColorMod(Textures[frame], _red, _green, _blue);
+				SDL_SetTextureColorMod(Textures[frame], State.r, State.g, State.b);
 				//cout << "Blend " << SDLBlend() << "\n"; // DEBUG
-				SDL_SetTextureBlendMode(Textures[frame], SDLBlend());
-				SDL_SetTextureAlphaMod(Textures[frame], _alpha);
+				SDL_SetTextureBlendMode(Textures[frame], (SDL_BlendMode)FrameBlend(frame, State));
+				SDL_SetTextureAlphaMod(Textures[frame], State.alpha);
 				for (int dy = tsy - iy; dy < tey; dy += imgh) {
 					//cout << "(" << x << "," << y << ")\tdy:" << dy << "; tsy:" << tsy << " imgh:" << imgh << " th:" << th << "\n";
 					for (int dx = tsx - ix; dx < tex; dx += imgw) {
@@ -1055,18 +2903,13 @@ namespace Slyvina {
 							Target.h = Source.h;
 						}
 
-
-						// TQSG_Rect(dx, dy, imgw, imgh);//debug
-						if (frame < 0 || frame >= Textures.size()) {
-							Paniek("<IMAGE>.Tile(" + to_string(x) + "," + to_string(y) + "," + to_string(w) + "," + to_string(h) + ") Frame(" + to_string(frame) + "/" + to_string(Frames()) + "): Out of frame boundaries (framecount: " + to_string(Textures.size()) + ")"); return;
-						}
-
-
 						Target.x = AltScreen.X(Target.x);
 						Target.y = AltScreen.Y(Target.y);
 						Target.w = AltScreen.W(Target.w);
 						Target.h = AltScreen.H(Target.h);
-						SDL_RenderCopy(_Screen->gRenderer, Textures[frame], &Source, &Target);
+						if (Culled(Target)) continue;
+						if (Mapped(frame)) CopyFrame(frame, &Source, FRect(Target), State);
+						else SDL_RenderCopy(_Screen->gRenderer, Textures[frame], &Source, &Target);
 					}
 				}
 				//TQSG_ViewPort(ox, oy, ow, oh);
@@ -1075,12 +2918,10 @@ namespace Slyvina {
 
 #else
 				auto
-					x = ax + _originx,
-					y = ay + _originy,
+					x = ax + State.originx,
+					y = ay + State.originy,
 					ix = aix,
 					iy = aiy;
-
-				_LastError = "";
 				// todo: Fix issues with negative ix
 				/*???
 				if (iy>0)
@@ -1092,19 +2933,19 @@ namespace Slyvina {
 					//*/
 				if (ix < 0) {
 					//cout << "neg x:" << ix << " to ";
-					ix = (x - (Width() + ix)) % Width();
+					ix = (x - (RawWidth() + ix)) % RawWidth();
 					//cout << ix << "\n";
 				}
 				if (iy < 0) {
 					//cout << "neg x:" << ix << " to ";
-					iy = (y - (Height() + iy)) % Height();
+					iy = (y - (RawHeight() + iy)) % RawHeight();
 					//cout << ix << "\n";
 				}
 				//int ox, oy, ow, oh;
 				//TQSG_GetViewPort(&ox, &oy, &ow, &oh);
 				int tsx, tsy, tex, tey, tw, th;
-				int imgh = Height();
-				int imgw = Width();
+				int imgh = RawHeight();
+				int imgw = RawWidth();
 				/*
 				tsx = max(ox, x);
 				tsy = max(oy, y);
@@ -1124,9 +2965,9 @@ namespace Slyvina {
 				//TQSG_ViewPort(tsx, tsy, tw, th);
 				//TQSG_Rect(tsx, tsy, tw, th);
 				//cout << "for (int dy = tsy("<<tsy<<") - iy("<<iy<<")(" << (tsy - iy) << "); dy < tey(" << tey << "); dy += imgh(" << imgh << ")) \n";
-				SDL_SetTextureColorMod(Textures[frame], _red, _green, _alpha);
-				SDL_SetTextureBlendMode(Textures[frame], SDLBlend());
-				SDL_SetTextureAlphaMod(Textures[frame], _alpha);
+				SDL_SetTextureColorMod(Textures[frame], State.r, State.g, State.alpha);
+				SDL_SetTextureBlendMode(Textures[frame], (SDL_BlendMode)FrameBlend(frame, State));
+				SDL_SetTextureAlphaMod(Textures[frame], State.alpha);
 				for (int dy = tsy - iy; dy < tey; dy += imgh) {
 					//cout << "(" << x << "," << y << ")\tdy:" << dy << "; tsy:" << tsy << " imgh:" << imgh << " th:" << th << "\n";
 					for (int dx = tsx - ix; dx < tex; dx += imgw) {
@@ -1168,12 +3009,9 @@ namespace Slyvina {
 							Target.h = Source.h;
 						}
 
-
-						// TQSG_Rect(dx, dy, imgw, imgh);//debug
-						if (frame < 0 || frame >= Textures.size()) {
-							Paniek("<IMAGE>.Tile(" + to_string(x) + "," + to_string(y) + "," + to_string(w) + "," + to_string(h) + "," + to_string(frame) + "): Out of frame boundaries (framecount: " + to_string(Textures.size()) + ")"); return;
-						}
-						SDL_RenderCopy(_Screen->gRenderer, Textures[frame], &Source, &Target);
+						if (Culled(Target)) continue;
+						if (Mapped(frame)) CopyFrame(frame, &Source, FRect(Target), State);
+						else SDL_RenderCopy(_Screen->gRenderer, Textures[frame], &Source, &Target);
 					}
 				}
 				//TQSG_ViewPort(ox, oy, ow, oh);
@@ -1183,10 +3021,7 @@ namespace Slyvina {
 			} catch (runtime_error re) {
 				char t[255];
 				sprintf_s(t, "TImage::Tile(%d,%d,%d,%d,%d,%d,%d):", ax, ay, w, h, frame, aix, aiy);
-				_LastError = string(t) + string(re.what());
-				cout << "ERROR: " << _LastError << endl;
-				SetColor(255, 0, 0);
-				Rect(aix, aiy, w, h);
+				cout << "ERROR: " << t << re.what() << endl; // LastError() is left alone, as this may run on the render thread
 			}
 		}
 #pragma endregion
@@ -1218,6 +3053,7 @@ namespace Slyvina {
 			uint64
 				defs{ 0 };
 			~_____TIMAGEFONTCHAR() {
+				__RenderLock Lock(_RenderMutex);
 				if (ChImg) SDL_DestroyTexture(ChImg);
 			}
 			_____TIMAGEFONTCHAR(_____TIMAGEFONT* Ouwe, SDL_Texture* _Img, int _x=0, int _y=0, int _w=0, int _h=0) {
@@ -1233,19 +3069,20 @@ namespace Slyvina {
 				defs = 1;
 				Chat("Character made! ImgPointer(" << (uint64)ChImg << ") hot(" << hotx << "," << hoty << ");  Size: " << width << "x" << height);
 			}
-			void Draw(int x,int y){
+			void Draw(int x, int y, const TDrawState& State){
 				if (!ChImg) return;
 				Chat("Draw char at (" << x << "," << y << ")\n"); // debug only!
 				int _w, _h;
 				SDL_QueryTexture(ChImg, NULL, NULL, &_w, &_h);
 				SDL_Rect Target;
-				Target.x = AltScreen.X(x + _originx);
-				Target.y = AltScreen.Y(y + _originy);
+				Target.x = AltScreen.X(x + State.originx);
+				Target.y = AltScreen.Y(y + State.originy);
 				Target.w = AltScreen.W(_w);
 				Target.h = AltScreen.H(_h);
-				SDL_SetTextureBlendMode(ChImg, SDLBlend());
-				SDL_SetTextureAlphaMod(ChImg, _alpha);
-				SDL_SetTextureColorMod(ChImg, _red, _green, _blue);
+				if (Culled(Target)) return;
+				SDL_SetTextureBlendMode(ChImg, (SDL_BlendMode)State.blend);
+				SDL_SetTextureAlphaMod(ChImg, State.alpha);
+				SDL_SetTextureColorMod(ChImg, State.r, State.g, State.b);
 				SDL_RenderCopy(_Screen->gRenderer, ChImg, NULL, &Target);
 			}
 		};
@@ -1264,67 +3101,75 @@ namespace Slyvina {
 			//if (!CharPics) { Paniek("Internal error!"); return nullptr; }
 			//Chat("Getting char #" << c); // ???
 			//if (!CharPics.count(c)) {
-			if (!CharPics[c]){
-				std::string WantFile{ "" };
-				int x{ 0 }, y{ 0 }, w{ 0 }, h{ 0 };
-				if (Alt) {
-					auto Cat{ TrSPrintF("%04x",c) };
-					if (Alt->HasValue(Cat, "LINK")) {
-						auto Lch = GetChar(ToInt(Alt->Value(Cat, "LINK")));
-						Lch->defs++;
-						CharPics[c] = Lch;
-						return Lch;
-					}
+			// The render thread calls this too (through Text()) while it holds the render lock.
+			// CharMutex is therefore never held while waiting for the render lock, or the two threads could lock each other out.
+			std::shared_ptr<_____TIMAGEFONTCHAR> Ch{ nullptr };
+			std::unique_lock<std::mutex> Lock(CharMutex);
+			if (CharPics[c]) return CharPics[c];
+			std::string WantFile{ "" };
+			int x{ 0 }, y{ 0 }, w{ 0 }, h{ 0 }, Link{ -1 };
+			if (Alt) {
+				auto Cat{ TrSPrintF("%04x",c) };
+				if (Alt->HasValue(Cat, "LINK")) {
+					Link = ToInt(Alt->Value(Cat, "LINK"));
+				} else {
 					if (Alt->HasValue(Cat, "Entry")) {
-						WantFile = pathprefix+Alt->Value(Cat, "Entry");
+						WantFile = pathprefix + Alt->Value(Cat, "Entry");
 					}
 					if (Alt->HasValue(Cat, "HOTX")) x = ToInt(Alt->Value(Cat, "HOTX"));
 					if (Alt->HasValue(Cat, "HOTY")) y = ToInt(Alt->Value(Cat, "HOTY"));
 					if (Alt->HasValue(Cat, "WIDTH")) w = ToInt(Alt->Value(Cat, "WIDTH"));
 					if (Alt->HasValue(Cat, "HEIGHT")) w = ToInt(Alt->Value(Cat, "HEIGHT"));
 				}
-				if (!WantFile.size()) {
-					for (byte i = 0; i < TryFmtMax; i++) {
-						auto fn{ pathprefix + TrSPrintF(TryFmt[i],c) };
-						if (FntRes->EntryExists(fn)) {
-							Chat("For character #" << c << ", file " << fn << " has been found!");
-							WantFile = fn;
+			}
+			if (Link < 0 && !WantFile.size()) {
+				for (byte i = 0; i < TryFmtMax; i++) {
+					auto fn{ pathprefix + TrSPrintF(TryFmt[i],c) };
+					if (FntRes->EntryExists(fn)) {
+						Chat("For character #" << c << ", file " << fn << " has been found!");
+						WantFile = fn;
+						break;
+					} else if (c>255) {
+						auto a{ c / 256 }, b{ c % 256 };
+						auto fn2{ pathprefix + TrSPrintF(TryFmt2[i],a,b) };
+						if (FntRes->EntryExists(fn2)) {
+							Chat("For character #" << c << ", file " << fn2 << " has been found!");
+							WantFile = fn2;
 							break;
-						} else if (c>255) {
-							auto a{ c / 256 }, b{ c % 256 };
-							auto fn2{ pathprefix + TrSPrintF(TryFmt2[i],a,b) };
-							if (FntRes->EntryExists(fn2)) {
-								Chat("For character #" << c << ", file " << fn2 << " has been found!");
-								WantFile = fn2;
-								break;
-							}
 						}
 					}
 				}
-				if (!WantFile.size()) {
-					std::cout << "WARNING! No suitable character image found for #" << c << ". ("<<pathprefix<<")\n";
-					//CharPics[c] = new _____TIMAGEFONTCHAR(this, nullptr);
-					CharPics[c] = std::make_shared<_____TIMAGEFONTCHAR>(this, nullptr);
-				} else {
-					//std::cout << "Loading char: " << WantFile << std::endl; // debug
-					auto buf = FntRes->B(WantFile);
+			}
+			if (Link >= 0) {
+				Lock.unlock();
+				Ch = GetChar(Link);
+				Lock.lock();
+				if (Ch) Ch->defs++;
+			} else if (!WantFile.size()) {
+				std::cout << "WARNING! No suitable character image found for #" << c << ". ("<<pathprefix<<")\n";
+				//CharPics[c] = new _____TIMAGEFONTCHAR(this, nullptr);
+				Ch = std::make_shared<_____TIMAGEFONTCHAR>(this, nullptr);
+			} else {
+				//std::cout << "Loading char: " << WantFile << std::endl; // debug
+				auto buf = FntRes->B(WantFile);
+				Lock.unlock();
+				{
 					auto rwo = SDL_RWFromMem(buf->Direct(), buf->Size());
+					__RenderLock RLock(_RenderMutex);
 					auto tex = IMG_LoadTexture_RW(_Screen->gRenderer, rwo, true);
 					//CharPics[c] = new _____TIMAGEFONTCHAR(this, tex, x, y, w, h);
-					CharPics[c] = std::make_shared< _____TIMAGEFONTCHAR>(this, tex, x, y, w, h);
-				}
-				if (spaceavg) {
-					uint32 count{ 0 }, total{ 0 };
-					for (auto i = 0; i < 256 * 256;i++) {
-						if (CharPics[i]) {
-							count++;
-							total += CharPics[i]->width;
-						}
-					}
-					if (count)	spacewidth = total / count;
+					Ch = std::make_shared< _____TIMAGEFONTCHAR>(this, tex, x, y, w, h);
 				}
+				Lock.lock();
 			}
-			return CharPics[c];
+			// Another thread may have loaded the same character while the lock was released. Theirs wins; ours is released after Lock.
+			if (CharPics[c] || !Ch) return CharPics[c];
+			CharPics[c] = Ch;
+			// Running average, in stead of scanning all 64K slots for every new character.
+			CharCount++;
+			CharTotal += Ch->width;
+			if (spaceavg) spacewidth = (int)(CharTotal / CharCount);
+			return Ch;
 		}
 		//_____TIMAGEFONTCHAR* _____TIMAGEFONT::GetChar(byte b1, byte b2) {
 		std::shared_ptr<_____TIMAGEFONTCHAR> _____TIMAGEFONT::GetChar(byte b1, byte b2) {
@@ -1332,7 +3177,12 @@ namespace Slyvina {
 			return GetChar(((uint64)b1 * 256) + (uint64)b2);
 		}
 
-		void _____TIMAGEFONT::TW(std::string Text, bool Draw, int& x, int& y) {
+		void _____TIMAGEFONT::TW(std::string Text, bool Draw, int& x, int& y, const TDrawState* State) {
+			TDrawState Global;
+			if (Draw && !State) {
+				Global = CurrentState();
+				State = &Global;
+			}
 			int
 				_x = x,
 				_y = y,
@@ -1374,7 +3224,7 @@ namespace Slyvina {
 						}
 						auto ch{ GetChar((byte)Text[pos + 1],(byte)Text[pos + 2]) };
 						dchar = 2;
-						if (Draw) ch->Draw(_x, _y);
+						if (Draw) ch->Draw(_x, _y, *State);
 						_x += ch->width;
 						_lineheight = std::max(_lineheight, ch->height);
 					} break;
@@ -1384,7 +3234,7 @@ namespace Slyvina {
 					default: {
 						auto ch{ GetChar((int32)Text[pos]) };
 						//Chat("Draw (" << ch << ") " << Draw << "!\n"); // debug only
-						if (Draw) ch->Draw(_x, _y);
+						if (Draw) ch->Draw(_x, _y, *State);
 						_x += ch->width;
 						_lineheight = std::max(_lineheight, ch->height);
 					} break;
@@ -1419,6 +3269,12 @@ namespace Slyvina {
 
 		}
 		void _____TIMAGEFONT::Text(std::string Text, int x, int y, Align ax,Align ay) {
+			if ((int)ax > 2) { Paniek("Unknown horizontal alignment"); return; }
+			if ((int)ay > 2) { Paniek("Unknown vertical alignment"); return; }
+			this->Text(Text, x, y, ax, ay, CurrentState());
+		}
+
+		void _____TIMAGEFONT::Text(std::string Text, int x, int y, Align ax, Align ay, const TDrawState& State) {
 			int sx{0}, sy{0};
 			switch (ax) {
 			case Align::Left:
@@ -1430,7 +3286,7 @@ namespace Slyvina {
 				sx = x - (Width(Text) / 2); // -(x / 2);
 				break;
 			default:
-				Paniek("Unknown horizontal alignment"); return;
+				return;
 			}
 			switch (ay) {
 			case Align::Top:
@@ -1442,9 +3298,9 @@ namespace Slyvina {
 				sy = y - (Height(Text) / 2); //- (y / 2);
 				break;
 			default:
-				Paniek("Unknown vertical alignment"); return;
+				return;
 			}
-			TW(Text, true, sx, sy);
+			TW(Text, true, sx, sy, &State);
 		}
 
 		void _____TIMAGEFONT::Dark(std::string _Text, int x, int y, Align ax , Align ay) {
@@ -22,6 +22,8 @@
 // C++
 #include <iostream>
 #include <string>
+#include <vector>
+#include <algorithm>
 
 // Slyvina Units
 #include <SlyvRandom.hpp>
@@ -67,16 +69,40 @@ namespace Slyvina {
 			PicBlop{ nullptr };
 
 
-		static int
-			C[200],
-			D[200],
-			E[200],
-			F[200],
-			E2[200],
-			F2[200];
+		// Structure of arrays, sized by NewBlopPlasma, so there's no limit on the number of blops anymore
+		static std::vector<int>
+			C{},
+			D{},
+			E{},
+			F{},
+			E2{},
+			F2{};
+
+		static std::vector<float>
+			K{};
+
+		static std::vector<byte>
+			ColR{},
+			ColG{},
+			ColB{};
+
+		static TQuadBatch
+			BlopBatch{};
 
+		// Offscreen rendering (see BlopPlasmaResolution)
 		static double
-			K[200];
+			PlasmaFraction{ 1 };
+		static int
+			PlasmaEveryNth{ 1 },
+			PlasmaFrame{ 0 };
+		static TUCanvas
+			PlasmaCanvas{ nullptr };
+		static void ReleasePlasmaCanvas() { PlasmaCanvas = nullptr; }
+		class __PlasmaGuard { // When this file's statics go first, the close hook may not be called anymore
+		public:
+			inline ~__PlasmaGuard() { RemoveCloseHook("TQSG_BlopPlasma"); }
+		};
+		static __PlasmaGuard _PlasmaGuard;
 
 		void InitBlopPlasma(JCR6::JT_Dir J, std::string entry, int NumberOfBlops, int Width, int Height, int BlopRadius) {
 			Print("Initiating Blop Plasma");
@@ -102,15 +128,20 @@ namespace Slyvina {
 
 		void NewBlopPlasma(int NumberOfBlops, int Width, int Height) {
 			//int G{ 0 };
-			Blops = NumberOfBlops;
+			Blops = std::max(0, NumberOfBlops);
 			PlasmaWidth = Width;
 			PlasmaHeight = Height;
+			C.resize(Blops); D.resize(Blops);
+			E.resize(Blops); F.resize(Blops);
+			E2.resize(Blops); F2.resize(Blops);
+			K.resize(Blops);
+			ColR.resize(Blops); ColG.resize(Blops); ColB.resize(Blops);
 			for (int G = 0; G <= Blops - 1; G++) { // Not the best formula, but I'm trying to be as close to the original code as possible
 				C[G] = Rand.Get(0, PlasmaHeight);
 				D[G] = Rand.Get(0, PlasmaWidth);
 				E[G] = Rand.Get(0, 4) - 2; E2[G] = abs(E[G]);
 				F[G] = Rand.Get(0, 4) - 2; F2[G] = abs(F[G]);
-				K[G] = C[G];
+				K[G] = (float)C[G];
 			}
 		}
 
@@ -118,73 +149,146 @@ namespace Slyvina {
 			DrawBlopPlasma(1, 1, 1, NumBlops, Chat);
 		}
 
+		static void MoveBlops(int NBlops) {
+			// No if-statements in here, so the compiler can turn these into vector instructions.
+			int
+				* c{ C.data() }, * d{ D.data() }, * e{ E.data() }, * f{ F.data() },
+				* e2{ E2.data() }, * f2{ F2.data() };
+			float
+				* k{ K.data() };
+			const int
+				PW{ PlasmaWidth },
+				PH{ PlasmaHeight };
+			for (int G = 0; G < NBlops; G++) c[G] += e[G];
+			for (int G = 0; G < NBlops; G++) d[G] += f[G];
+			// Bounce back from the edges
+			for (int G = 0; G < NBlops; G++) e[G] = c[G] >= PW ? -e2[G] : (c[G] <= 0 ? e2[G] : e[G]);
+			for (int G = 0; G < NBlops; G++) f[G] = d[G] >= PH ? -f2[G] : (d[G] <= 0 ? f2[G] : f[G]);
+			for (int G = 0; G < NBlops; G++) k[G] += (float)N;
+			for (int G = 0; G < NBlops; G++) k[G] = k[G] > 360 ? k[G] - 360 : k[G];
+		}
+
+		static void ColorBlops(int NBlops, double PlasR, double PlasG, double PlasB) {
+			// The old "% 256" only kept the lowest 8 bits, which is exactly what casting to byte does as well.
+			const float
+				pr{ (float)PlasR },
+				pg{ (float)PlasG },
+				pb{ (float)PlasB };
+			const int
+				* c{ C.data() }, * d{ D.data() };
+			const float
+				* k{ K.data() };
+			byte
+				* r{ ColR.data() }, * g{ ColG.data() }, * b{ ColB.data() };
+			for (int G = 0; G < NBlops; G++) r[G] = (byte)(int)floorf((Z - k[G]) * pr);
+			if (PlasG == 1 && PlasB == 1) {
+				// Most common case. All integer, so no need for floor
+				for (int G = 0; G < NBlops; G++) g[G] = (byte)(Z - c[G]);
+				for (int G = 0; G < NBlops; G++) b[G] = (byte)(Z - d[G]);
+			} else {
+				for (int G = 0; G < NBlops; G++) g[G] = (byte)(int)floorf((Z - c[G]) * pg);
+				for (int G = 0; G < NBlops; G++) b[G] = (byte)(int)floorf((Z - d[G]) * pb);
+			}
+		}
+
+		void BlopPlasmaResolution(double Fraction, int EveryNthFrame) {
+			PlasmaFraction = std::min(1.0, std::max(0.01, Fraction));
+			PlasmaEveryNth = std::max(1, EveryNthFrame);
+			PlasmaFrame = 0;
+		}
+
+		static bool NeedPlasmaTarget() {
+			if (!GetRenderer()) return false;
+			int
+				w{ std::max(1, (int)ceil(PlasmaWidth * PlasmaFraction)) },
+				h{ std::max(1, (int)ceil(PlasmaHeight * PlasmaFraction)) };
+			if (PlasmaCanvas && PlasmaCanvas->Width() == w && PlasmaCanvas->Height() == h) return true;
+			PlasmaCanvas = CreateUCanvas(w, h);
+			PlasmaFrame = 0;
+			AddCloseHook("TQSG_BlopPlasma", ReleasePlasmaCanvas);
+			if (!PlasmaCanvas) {
+				Print("Creating plasma canvas failed: " << LastError());
+				return false;
+			}
+			return true;
+		}
+
+		// Puts all blops in the batch. (fx,fy) multiplies positions and sizes, (offx,offy) is added to the positions before that.
+		static void BatchBlops(int NBlops, float fx, float fy, float offx, float offy) {
+			double sx, sy;
+			GetScale(sx, sy);
+			float
+				bw{ (float)ceil(PicBlop->Width() * sx) * fx },
+				bh{ (float)ceil(PicBlop->Height() * sy) * fy },
+				hx{ (float)ceil(PicBlop->HotX() * sx) },
+				hy{ (float)ceil(PicBlop->HotY() * sy) };
+			byte
+				a{ GetAlpha() };
+			bool
+				Mapped{ PicBlop->Mapped(0) };
+			SDL_Rect Source;
+			auto Tex{ PicBlop->GetFrame(0) };
+			for (auto G = 0; G < NBlops; G++) {
+				SDL_FRect Target{ (C[G] - hx + offx) * fx, (D[G] - hy + offy) * fy, bw, bh };
+				if (Mapped && !(Tex = PicBlop->MapFrame(0, Target, Source))) continue;
+				BlopBatch.Start(Tex, Blend::ADDITIVE);
+				BlopBatch.Add(Target, Mapped ? &Source : NULL, ColR[G], ColG[G], ColB[G], a);
+			}
+			BlopBatch.Flush();
+		}
+
 		void DrawBlopPlasma(double PlasR, double PlasG, double PlasB, int NumBlops, bool Chat) {
-			std::string
-				CTxt{ "" };
 			int
-				//G = 0,
-				CX = 0,
-				CY = 0,
-				NBlops = Blops;			
+				NBlops = Blops;
 			Blend
 				Blend = GetBlend();
 
-			//std::cout << "Test!\n";
-
-			if (NumBlops) NBlops = NumBlops;
+			if (NumBlops) NBlops = std::min(NumBlops, Blops); // Going beyond the number of blops was a buffer overrun before. Not anymore!
 			Cls();
-			//TQSG_SetBlend(TQSG_Blend::COLOR);//4
-			SetBlend(Blend::ADDITIVE);
-			for (auto G = 0; G <= NBlops - 1; G++) {// For G = 0 To NBlops - 1
-				//std::cout << "G:" << G << "; C:" << C[G] << "; E:" << E[G] << "; D:" << D[G] << "; F:" << F[G] << std::endl; // Debug
-				C[G] += E[G];
-				D[G] += F[G];
-				if (C[G] >= PlasmaWidth) { //Then
-					E[G] = -E2[G];
-					if (E[G] > 0) E[G] = E2[G];
-				}
-				if (D[G] >= PlasmaHeight) { // Then
-					F[G] = -F2[G];
-					if (F[G] > 0) F[G] = F2[0];
-				}
-				if (C[G] <= 0) {// Then
-					E[G] = E2[G];
-					if (E[G] < 0) E[G] = -E2[G];
-				}
-				if (D[G] <= 0) { // Then
-					F[G] = F2[G];
-					if (F[G] < 0) E[G] = -F2[G];
+			if (!PicBlop || NBlops <= 0) return;
+			MoveBlops(NBlops);
+
+			double rx, ry;
+			int ox, oy;
+			AltScreenRatio(rx, ry);
+			GetOrigin(ox, oy);
+			if ((PlasmaFraction < 1 || PlasmaEveryNth > 1) && NeedPlasmaTarget()) {
+				// Render into the small canvas (only when it's time to, or when the driver threw its content away) and stretch that over the plasma area.
+				// Blops sticking out of the plasma area are cut off here, unlike when drawing directly.
+				auto Rend{ GetRenderer() };
+				if ((PlasmaFrame++ % PlasmaEveryNth == 0 || PlasmaCanvas->Lost()) && PushTarget(PlasmaCanvas)) {
+					Cls();
+					ColorBlops(NBlops, PlasR, PlasG, PlasB);
+					BatchBlops(NBlops, (float)PlasmaCanvas->Width() / PlasmaWidth, (float)PlasmaCanvas->Height() / PlasmaHeight, 0, 0);
+					PopTarget();
 				}
-				K[G] += N;
-				if (K[G] > 360) K[G] -= 360;
-				// 'SetColor (PlasmaWidth-K[G])*PlasR,(Z-C[G])*PlasG,(Z-D[G])*PlasB
-				SetColor((int)(floor((double)(Z - K[G]) * PlasR)) % 256, (int)(floor((double)(Z - C[G]) * PlasG)) % 256, (int)(floor((double)(Z - D[G]) * PlasB)) % 256);
-				//TQSG_Rotate(K[G]);
-				//std::cout << G << ":\t Color(" << floor((double)(Z - K[G]) * PlasR) << "," << floor((double)(Z - C[G]) * PlasG) << "," << floor((double)(Z - D[G]) * PlasB) << "\n";
-				//std::cout << G << ":\tPicBlop->Draw(" << C[G] << "," << D[G] << ")\n";
-				PicBlop->Draw(C[G], D[G]); // DrawImage PicBlop, C[G], D[G]
-				//TQSG_Circle(C[G], D[G], 100);
-				if (Chat) {// Then
-					//SetBlend maskblend
-					// SetRotation 0
-					// CTxt = "Object: " + G + " (" + C[G] + "," + D[G] + ") M(" + E[G] + "," + F[G] + ")"
-					// CX = 0
-					// CY = G * 15
-					//While CY>PlasmaHeight - 15
-					//CY:-(PlasmaHeight - 15);
-				//CX:+300;
-				// Wend
-					// SetColor 0, 0, 0
-					// DrawText CTXT, CX + 2, CY + 2
-					// SetColor 255, 255, 255
-					// DrawText CTXT, CX, CY
-					// SetBlend 4
-				}// EndIf
-			}//  Next
+				auto PlasmaTarget{ PlasmaCanvas->GetTexture() };
+				SDL_SetTextureBlendMode(PlasmaTarget, SDL_BLENDMODE_NONE); // It already contains the cleared background, so it can just replace what's there
+				SDL_SetTextureAlphaMod(PlasmaTarget, 255);
+				SDL_SetTextureColorMod(PlasmaTarget, 255, 255, 255);
+#if SDL_VERSION_ATLEAST(2,0,12)
+				SDL_SetTextureScaleMode(PlasmaTarget, SDL_ScaleModeLinear); // Set every time, as the texture may have been replaced after a driver reset
+#endif
+				SDL_FRect Area{ (float)(ox * rx), (float)(oy * ry), (float)(PlasmaWidth * rx), (float)(PlasmaHeight * ry) };
+#if SDL_VERSION_ATLEAST(2,0,10)
+				SDL_RenderCopyF(Rend, PlasmaTarget, NULL, &Area);
+#else
+				SDL_Rect IArea{ (int)Area.x, (int)Area.y, (int)ceil(Area.w), (int)ceil(Area.h) };
+				SDL_RenderCopy(Rend, PlasmaTarget, NULL, &IArea);
+#endif
+			} else {
+				// All blops in one go. Same result as PicBlop->Draw(C[G], D[G]) for every blop, but only one call to SDL.
+				ColorBlops(NBlops, PlasR, PlasG, PlasB);
+				BatchBlops(NBlops, (float)rx, (float)ry, (float)ox, (float)oy);
+			}
+#ifdef BlopPlasmaChat
+			if (Chat) {
+				for (auto G = 0; G < NBlops; G++) Print("Object: " << G << " (" << C[G] << "," << D[G] << ") M(" << E[G] << "," << F[G] << ")");
+			}
+#endif
 			Rotate(0);
 			SetColor(255, 255, 255);
 			SetBlend(Blend);
-			//PicBlop->Draw(20, 20);
 		}
 
 		void SetPlasmaBlop(std::string File) {
@@ -0,0 +1,303 @@
+// License:
+// 	TQSL/Source/TQSG_Capture.cpp
+// 	Tricky's Quick SDL2 Graphics - Screen capture
+// 	version: 26.10.19
+//
+// 	Copyright (C) 2026 Jeroen P. Broks
+//
+// 	This software is provided 'as-is', without any express or implied
+// 	warranty.  In no event will the authors be held liable for any damages
+// 	arising from the use of this software.
+//
+// 	Permission is granted to anyone to use this software for any purpose,
+// 	including commercial applications, and to alter it and redistribute it
+// 	freely, subject to the following restrictions:
+//
+// 	1. The origin of this software must not be misrepresented; you must not
+// 	   claim that you wrote the original software. If you use this software
+// 	   in a product, an acknowledgment in the product documentation would be
+// 	   appreciated but is not required.
+// 	2. Altered source versions must be plainly marked as such, and must not be
+// 	   misrepresented as being the original software.
+// 	3. This notice may not be removed or altered from any source distribution.
+// End License
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <SlyvString.hpp>
+
+#include "../Headers/TQSG.hpp"
+#include "../Headers/TQSG_Capture.hpp"
+
+namespace Slyvina {
+	namespace TQSG {
+
+		enum class __BufState { Free, Reading, Filled, Encoding };
+
+		class __CaptureBuffer {
+		public:
+			__BufState State{ __BufState::Free };
+			std::vector<byte> Pixels{};
+			int
+				w{ 0 },
+				h{ 0 };
+			std::string File{ "" };
+			CaptureFormat Format{ CaptureFormat::PNG };
+			uint64 Seq{ 0 };
+		};
+
+		class __CaptureRequest {
+		public:
+			std::string File;
+			CaptureFormat Format;
+		};
+
+		static std::vector<__CaptureBuffer> _Buffers(8);
+		static int _NumThreads{ 2 };
+		static CaptureDrop _Policy{ CaptureDrop::Newest };
+		static std::vector<std::thread> _Workers{};
+		static std::mutex _CMutex;
+		static std::condition_variable
+			_CWork,
+			_CFree;
+		static bool
+			_CStop{ false },
+			_Recording{ false },
+			_HookSet{ false };
+		static std::string
+			_RecPrefix{ "" },
+			_CaptureError{ "" };
+		static CaptureFormat _RecFormat{ CaptureFormat::PNG };
+		static int _RecEvery{ 1 };
+		static uint64
+			_RecFrame{ 0 },
+			_RecCount{ 0 },
+			_Seq{ 0 },
+			_Written{ 0 },
+			_Dropped{ 0 };
+		static std::vector<__CaptureRequest> _Shots{};
+
+		// Only call these with _CMutex locked
+		static bool Idle() {
+			if (_Recording || _Shots.size()) return false;
+			for (auto& B : _Buffers) if (B.State != __BufState::Free) return false;
+			return true;
+		}
+		static __CaptureBuffer* Oldest(__BufState State) {
+			__CaptureBuffer* ret{ nullptr };
+			for (auto& B : _Buffers) if (B.State == State && ((!ret) || B.Seq < ret->Seq)) ret = &B;
+			return ret;
+		}
+		static __CaptureBuffer* FreeBuffer() {
+			for (auto& B : _Buffers) if (B.State == __BufState::Free) return &B;
+			return nullptr;
+		}
+
+		static bool Encode(__CaptureBuffer& B, std::string& Error) {
+			switch (B.Format) {
+			case CaptureFormat::PNG: {
+				auto Surf{ SDL_CreateRGBSurfaceWithFormatFrom(B.Pixels.data(), B.w, B.h, 32, B.w * 4, SDL_PIXELFORMAT_RGBA32) };
+				if (!Surf) { Error = "Surface for " + B.File + " could not be created: " + SDL_GetError(); return false; }
+				auto ret{ IMG_SavePNG(Surf, B.File.c_str()) == 0 };
+				if (!ret) Error = "Saving " + B.File + " failed: " + IMG_GetError();
+				SDL_FreeSurface(Surf);
+				return ret;
+			}
+			case CaptureFormat::Raw: {
+				std::ofstream Out{ B.File, std::ios::binary };
+				if (!Out) { Error = "Could not write " + B.File; return false; }
+				Out.write((const char*)B.Pixels.data(), B.Pixels.size());
+				return (bool)Out;
+			}
+			}
+			return false;
+		}
+
+		static void CaptureWorker() {
+			while (true) {
+				std::unique_lock<std::mutex> L(_CMutex);
+				_CWork.wait(L, [] { return _CStop || Oldest(__BufState::Filled); });
+				auto B{ Oldest(__BufState::Filled) };
+				if (!B) break; // Stop requested and nothing left to write
+				B->State = __BufState::Encoding; // From now on nobody else touches this buffer, so the lock can go
+				L.unlock();
+				std::string Error{ "" };
+				bool ok{ Encode(*B, Error) };
+				L.lock();
+				B->State = __BufState::Free;
+				if (ok) _Written++; else _CaptureError = Error;
+				L.unlock();
+				_CFree.notify_all();
+			}
+		}
+
+		static void StopWorkers() {
+			{
+				std::lock_guard<std::mutex> L(_CMutex);
+				_CStop = true;
+			}
+			_CWork.notify_all();
+			for (auto& W : _Workers) if (W.joinable()) W.join();
+			_Workers.clear();
+			_CStop = false;
+		}
+
+		class __CaptureGuard { // Writes whatever is still waiting and ends the threads before the program ends
+		public:
+			inline ~__CaptureGuard() { StopWorkers(); }
+		};
+		static __CaptureGuard _CGuard;
+
+		static void Grab(std::string File, CaptureFormat Format) {
+			auto Rend{ GetRenderer() };
+			if (!Rend) return;
+			__CaptureBuffer* B{ nullptr };
+			{
+				std::unique_lock<std::mutex> L(_CMutex);
+				B = FreeBuffer();
+				if (!B) switch (_Policy) {
+				case CaptureDrop::Newest:
+					_Dropped++;
+					return;
+				case CaptureDrop::Oldest:
+					B = Oldest(__BufState::Filled);
+					if (!B) { _Dropped++; return; } // All busy being written, so nothing to throw away either
+					_Dropped++;
+					break;
+				case CaptureDrop::Wait:
+					_CFree.wait(L, [&B] { return (B = FreeBuffer()) != nullptr; });
+					break;
+				}
+				B->State = __BufState::Reading;
+			}
+			int w, h;
+			SDL_GetRendererOutputSize(Rend, &w, &h);
+			B->w = w;
+			B->h = h;
+			B->Pixels.resize((size_t)w * h * 4);
+			B->File = File;
+			B->Format = Format;
+			// Reading is relative to the viewport, so read with none at all
+			SDL_Rect VP;
+			SDL_RenderGetViewport(Rend, &VP);
+			SDL_RenderSetViewport(Rend, NULL);
+			auto Failed{ SDL_RenderReadPixels(Rend, NULL, SDL_PIXELFORMAT_RGBA32, B->Pixels.data(), w * 4) };
+			SDL_RenderSetViewport(Rend, &VP);
+			{
+				std::lock_guard<std::mutex> L(_CMutex);
+				if (Failed) {
+					_CaptureError = std::string("Reading pixels failed: ") + SDL_GetError();
+					B->State = __BufState::Free;
+					_CFree.notify_all();
+					return;
+				}
+				B->Seq = ++_Seq;
+				B->State = __BufState::Filled;
+			}
+			_CWork.notify_one();
+		}
+
+		static void CaptureHook() {
+			std::vector<__CaptureRequest> Todo{};
+			{
+				std::lock_guard<std::mutex> L(_CMutex);
+				Todo.swap(_Shots);
+				if (_Recording && (_RecFrame++ % _RecEvery) == 0) {
+					_RecCount++;
+					std::string File{ _RecPrefix + Units::TrSPrintF("%06llu", (unsigned long long)_RecCount) };
+					if (_RecFormat == CaptureFormat::PNG) {
+						File += ".png";
+					} else {
+						int w, h;
+						SDL_GetRendererOutputSize(GetRenderer(), &w, &h);
+						File += Units::TrSPrintF("_%dx%d.rgba", w, h);
+					}
+					Todo.push_back({ File, _RecFormat });
+				}
+			}
+			for (auto& T : Todo) Grab(T.File, T.Format);
+		}
+
+		static bool NeedCapture() {
+			if (!GetRenderer()) {
+				std::lock_guard<std::mutex> L(_CMutex);
+				_CaptureError = "Capturing requires a graphics screen";
+				return false;
+			}
+			if (!_Workers.size()) for (int i = 0; i < std::max(1, _NumThreads); i++) _Workers.push_back(std::thread(CaptureWorker));
+			if (!_HookSet) {
+				AddFlipHook("TQSG_Capture", CaptureHook);
+				_HookSet = true;
+			}
+			return true;
+		}
+
+		void CaptureDepth(size_t Buffers) {
+			std::lock_guard<std::mutex> L(_CMutex);
+			if (!Idle()) { _CaptureError = "CaptureDepth(): Can't change this while capturing"; return; }
+			_Buffers.resize(std::max((size_t)1, Buffers));
+		}
+
+		void CaptureThreads(int Threads) {
+			{
+				std::lock_guard<std::mutex> L(_CMutex);
+				if (!Idle()) { _CaptureError = "CaptureThreads(): Can't change this while capturing"; return; }
+				_NumThreads = std::max(1, Threads);
+			}
+			StopWorkers(); // They'll come back with the new number when needed
+		}
+
+		void CapturePolicy(CaptureDrop Policy) {
+			std::lock_guard<std::mutex> L(_CMutex);
+			_Policy = Policy;
+		}
+
+		bool Screenshot(std::string File, CaptureFormat Format) {
+			if (!NeedCapture()) return false;
+			std::lock_guard<std::mutex> L(_CMutex);
+			_Shots.push_back({ File, Format });
+			MarkChanged(); // Or in idle mode the next Flip() could skip the frame, and the hook with it
+			return true;
+		}
+
+		bool StartRecording(std::string Prefix, CaptureFormat Format, int EveryNth) {
+			if (!NeedCapture()) return false;
+			std::lock_guard<std::mutex> L(_CMutex);
+			_RecPrefix = Prefix;
+			_RecFormat = Format;
+			_RecEvery = std::max(1, EveryNth);
+			_RecFrame = 0;
+			_RecCount = 0;
+			_Written = 0;
+			_Dropped = 0;
+			_CaptureError = "";
+			_Recording = true;
+			MarkChanged();
+			return true;
+		}
+
+		void StopRecording() {
+			std::lock_guard<std::mutex> L(_CMutex);
+			_Recording = false;
+		}
+
+		bool Recording() {
+			std::lock_guard<std::mutex> L(_CMutex);
+			return _Recording;
+		}
+
+		void CaptureFinish() {
+			std::unique_lock<std::mutex> L(_CMutex);
+			if (!_Workers.size()) return;
+			_CFree.wait(L, [] { for (auto& B : _Buffers) if (B.State != __BufState::Free) return false; return true; });
+		}
+
+		uint64 CaptureWritten() { std::lock_guard<std::mutex> L(_CMutex); return _Written; }
+		uint64 CaptureDropped() { std::lock_guard<std::mutex> L(_CMutex); return _Dropped; }
+		std::string CaptureError() { std::lock_guard<std::mutex> L(_CMutex); return _CaptureError; }
+	}
+}
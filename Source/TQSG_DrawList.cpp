@@ -0,0 +1,254 @@
+// License:
+// 	TQSL/Source/TQSG_DrawList.cpp
+// 	Tricky's Quick SDL2 Graphics - Draw lists
+// 	version: 26.10.19
+//
+// 	Copyright (C) 2026 Jeroen P. Broks
+//
+// 	This software is provided 'as-is', without any express or implied
+// 	warranty.  In no event will the authors be held liable for any damages
+// 	arising from the use of this software.
+//
+// 	Permission is granted to anyone to use this software for any purpose,
+// 	including commercial applications, and to alter it and redistribute it
+// 	freely, subject to the following restrictions:
+//
+// 	1. The origin of this software must not be misrepresented; you must not
+// 	   claim that you wrote the original software. If you use this software
+// 	   in a product, an acknowledgment in the product documentation would be
+// 	   appreciated but is not required.
+// 	2. Altered source versions must be plainly marked as such, and must not be
+// 	   misrepresented as being the original software.
+// 	3. This notice may not be removed or altered from any source distribution.
+// End License
+
+#include <algorithm>
+
+#include "../Headers/TQSG.hpp"
+#include "../Headers/TQSG_DrawList.hpp"
+
+namespace Slyvina {
+	namespace TQSG {
+
+#pragma region State
+		bool TDrawState::operator==(const TDrawState& o) const {
+			return
+				r == o.r && g == o.g && b == o.b && alpha == o.alpha &&
+				blend == o.blend &&
+				scalex == o.scalex && scaley == o.scaley && rotatedeg == o.rotatedeg &&
+				originx == o.originx && originy == o.originy;
+		}
+
+		void TDrawState::Grab() {
+			GetColor(r, g, b);
+			alpha = GetAlpha();
+			blend = GetBlend();
+			GetScale(scalex, scaley);
+			rotatedeg = GetRotate();
+			GetOrigin(originx, originy);
+		}
+
+		void TDrawState::Apply() const {
+			SetColor(r, g, b);
+			SetAlpha(alpha);
+			SetBlend(blend);
+			SetScale(scalex, scaley);
+			Rotate(rotatedeg);
+			SetOrigin(originx, originy);
+		}
+
+		TDrawState GrabbedState() {
+			TDrawState ret;
+			ret.Grab();
+			return ret;
+		}
+#pragma endregion
+
+#pragma region Recording
+		TDrawRecord& _____TDRAWLIST::Rec(DrawCommand c) {
+			_Records.push_back(TDrawRecord());
+			auto& ret{ _Records.back() };
+			ret.Command = c;
+			ret.State = _State;
+			return ret;
+		}
+
+		void _____TDRAWLIST::Draw(TImage Img, int x, int y, int frame) {
+			auto& R{ Rec(DrawCommand::Draw) };
+			R.Img = Img; R.ImgPtr = Img.get();
+			R.i[0] = x; R.i[1] = y; R.frame = frame;
+		}
+		void _____TDRAWLIST::Draw(TUImage& Img, int x, int y, int frame) {
+			auto& R{ Rec(DrawCommand::Draw) };
+			R.ImgPtr = Img.get();
+			R.i[0] = x; R.i[1] = y; R.frame = frame;
+		}
+
+		void _____TDRAWLIST::XDraw(TImage Img, int x, int y, int frame) {
+			auto& R{ Rec(DrawCommand::XDraw) };
+			R.Img = Img; R.ImgPtr = Img.get();
+			R.i[0] = x; R.i[1] = y; R.frame = frame;
+		}
+		void _____TDRAWLIST::XDraw(TUImage& Img, int x, int y, int frame) {
+			auto& R{ Rec(DrawCommand::XDraw) };
+			R.ImgPtr = Img.get();
+			R.i[0] = x; R.i[1] = y; R.frame = frame;
+		}
+
+		void _____TDRAWLIST::StretchDraw(TImage Img, int x, int y, int w, int h, int frame) {
+			auto& R{ Rec(DrawCommand::StretchDraw) };
+			R.Img = Img; R.ImgPtr = Img.get();
+			R.i[0] = x; R.i[1] = y; R.i[2] = w; R.i[3] = h; R.frame = frame;
+		}
+		void _____TDRAWLIST::StretchDraw(TUImage& Img, int x, int y, int w, int h, int frame) {
+			auto& R{ Rec(DrawCommand::StretchDraw) };
+			R.ImgPtr = Img.get();
+			R.i[0] = x; R.i[1] = y; R.i[2] = w; R.i[3] = h; R.frame = frame;
+		}
+
+		void _____TDRAWLIST::Tile(TImage Img, int x, int y, int w, int h, int frame, int ix, int iy) {
+			auto& R{ Rec(DrawCommand::Tile) };
+			R.Img = Img; R.ImgPtr = Img.get();
+			R.i[0] = x; R.i[1] = y; R.i[2] = w; R.i[3] = h; R.i[4] = ix; R.i[5] = iy; R.frame = frame;
+		}
+		void _____TDRAWLIST::Tile(TUImage& Img, int x, int y, int w, int h, int frame, int ix, int iy) {
+			auto& R{ Rec(DrawCommand::Tile) };
+			R.ImgPtr = Img.get();
+			R.i[0] = x; R.i[1] = y; R.i[2] = w; R.i[3] = h; R.i[4] = ix; R.i[5] = iy; R.frame = frame;
+		}
+
+		void _____TDRAWLIST::Blit(TImage Img, int x, int y, int isx, int isy, int iex, int iey, int frame) {
+			auto& R{ Rec(DrawCommand::Blit) };
+			R.Img = Img; R.ImgPtr = Img.get();
+			R.i[0] = x; R.i[1] = y; R.i[2] = isx; R.i[3] = isy; R.i[4] = iex; R.i[5] = iey; R.frame = frame;
+		}
+		void _____TDRAWLIST::Blit(TUImage& Img, int x, int y, int isx, int isy, int iex, int iey, int frame) {
+			auto& R{ Rec(DrawCommand::Blit) };
+			R.ImgPtr = Img.get();
+			R.i[0] = x; R.i[1] = y; R.i[2] = isx; R.i[3] = isy; R.i[4] = iex; R.i[5] = iey; R.frame = frame;
+		}
+
+		void _____TDRAWLIST::Text(TImageFont Fnt, std::string Txt, int x, int y, Align ax, Align ay) {
+			auto& R{ Rec(DrawCommand::Text) };
+			R.Font = Fnt; R.FontPtr = Fnt.get();
+			R.Txt = Txt; R.i[0] = x; R.i[1] = y; R.ax = ax; R.ay = ay;
+		}
+		void _____TDRAWLIST::Text(TUImageFont& Fnt, std::string Txt, int x, int y, Align ax, Align ay) {
+			auto& R{ Rec(DrawCommand::Text) };
+			R.FontPtr = Fnt.get();
+			R.Txt = Txt; R.i[0] = x; R.i[1] = y; R.ax = ax; R.ay = ay;
+		}
+
+		void _____TDRAWLIST::Line(int start_x, int start_y, int end_x, int end_y) {
+			auto& R{ Rec(DrawCommand::Line) };
+			R.i[0] = start_x; R.i[1] = start_y; R.i[2] = end_x; R.i[3] = end_y;
+		}
+
+		void _____TDRAWLIST::Rect(int x, int y, int w, int h, bool open) {
+			auto& R{ Rec(DrawCommand::Rect) };
+			R.i[0] = x; R.i[1] = y; R.i[2] = w; R.i[3] = h; R.open = open;
+		}
+
+		void _____TDRAWLIST::Circle(int center_x, int center_y, int radius, int segments) {
+			auto& R{ Rec(DrawCommand::Circle) };
+			R.i[0] = center_x; R.i[1] = center_y; R.i[2] = radius; R.i[3] = segments;
+		}
+
+		void _____TDRAWLIST::Plot(int x, int y) {
+			auto& R{ Rec(DrawCommand::Plot) };
+			R.i[0] = x; R.i[1] = y;
+		}
+
+		void _____TDRAWLIST::Cls(byte r, byte g, byte b) {
+			auto& R{ Rec(DrawCommand::Cls) };
+			R.i[0] = r; R.i[1] = g; R.i[2] = b;
+		}
+
+		TDrawList CreateDrawList(int Order) {
+			auto ret{ std::make_shared<_____TDRAWLIST>() };
+			ret->Order = Order;
+			return ret;
+		}
+
+		TUDrawList CreateUDrawList(int Order) {
+			auto ret{ std::make_unique<_____TDRAWLIST>() };
+			ret->Order = Order;
+			return ret;
+		}
+#pragma endregion
+
+#pragma region Replay
+		// Every record carries its own state, which is handed to the drawing functions directly. The global settings are never touched, as the game may be changing them on another thread right now.
+		static void ReplayRecords(std::vector<TDrawRecord>& Records, TQuadBatch& Batch) {
+			for (auto& R : Records) {
+				switch (R.Command) {
+				case DrawCommand::Draw:
+					if (R.ImgPtr) R.ImgPtr->BatchDraw(Batch, R.i[0], R.i[1], R.frame, R.State);
+					continue; // No flush! That's the whole point.
+				case DrawCommand::XDraw:
+					if (R.ImgPtr) R.ImgPtr->BatchXDraw(Batch, R.i[0], R.i[1], R.frame, R.State);
+					continue;
+				default:
+					break;
+				}
+				// Everything below is drawn right away, so whatever is in the batch must go first, or the order gets messed up.
+				Batch.Flush();
+				switch (R.Command) {
+				case DrawCommand::StretchDraw:
+					if (R.ImgPtr) R.ImgPtr->StretchDraw(R.i[0], R.i[1], R.i[2], R.i[3], R.frame, R.State);
+					break;
+				case DrawCommand::Tile:
+					if (R.ImgPtr) R.ImgPtr->Tile(R.i[0], R.i[1], R.i[2], R.i[3], R.frame, R.i[4], R.i[5], R.State);
+					break;
+				case DrawCommand::Blit:
+					if (R.ImgPtr) R.ImgPtr->Blit(R.i[0], R.i[1], R.i[2], R.i[3], R.i[4], R.i[5], R.frame, R.State);
+					break;
+				case DrawCommand::Text:
+					if (R.FontPtr) R.FontPtr->Text(R.Txt, R.i[0], R.i[1], R.ax, R.ay, R.State);
+					break;
+				case DrawCommand::Line:
+					TQSG::Line(R.i[0], R.i[1], R.i[2], R.i[3], R.State);
+					break;
+				case DrawCommand::Rect:
+					TQSG::Rect(R.i[0], R.i[1], R.i[2], R.i[3], R.open, R.State);
+					break;
+				case DrawCommand::Circle:
+					TQSG::Circle(R.i[0], R.i[1], R.i[2], R.i[3], R.State);
+					break;
+				case DrawCommand::Plot:
+					TQSG::Plot(R.i[0], R.i[1], R.State);
+					break;
+				case DrawCommand::Cls:
+					TQSG::Cls((byte)R.i[0], (byte)R.i[1], (byte)R.i[2]);
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		void _____TDRAWLIST::Replay(TQuadBatch* Batch) {
+			if (Batch) ReplayRecords(_Records, *Batch); // Flushing is up to the caller, so the batch can go on into the next list
+			else {
+				TQuadBatch LocalBatch;
+				ReplayRecords(_Records, LocalBatch);
+				LocalBatch.Flush();
+			}
+		}
+
+		void ReplayDrawLists(std::vector<_____TDRAWLIST*>& Lists) {
+			Lists.erase(std::remove(Lists.begin(), Lists.end(), nullptr), Lists.end());
+			std::stable_sort(Lists.begin(), Lists.end(), [](_____TDRAWLIST* a, _____TDRAWLIST* b) { return a->Order < b->Order; });
+			TQuadBatch Batch;
+			for (auto L : Lists) L->Replay(&Batch);
+			Batch.Flush();
+		}
+
+		void ReplayDrawLists(std::vector<TDrawList>& Lists) {
+			std::vector<_____TDRAWLIST*> Ptrs{};
+			for (auto& L : Lists) Ptrs.push_back(L.get());
+			ReplayDrawLists(Ptrs);
+		}
+#pragma endregion
+	}
+}
@@ -0,0 +1,166 @@
+// License:
+// 	TQSL/Source/TQSG_Particles.cpp
+// 	Tricky's Quick SDL2 Graphics - Particles
+// 	version: 26.10.19
+//
+// 	Copyright (C) 2026 Jeroen P. Broks
+//
+// 	This software is provided 'as-is', without any express or implied
+// 	warranty.  In no event will the authors be held liable for any damages
+// 	arising from the use of this software.
+//
+// 	Permission is granted to anyone to use this software for any purpose,
+// 	including commercial applications, and to alter it and redistribute it
+// 	freely, subject to the following restrictions:
+//
+// 	1. The origin of this software must not be misrepresented; you must not
+// 	   claim that you wrote the original software. If you use this software
+// 	   in a product, an acknowledgment in the product documentation would be
+// 	   appreciated but is not required.
+// 	2. Altered source versions must be plainly marked as such, and must not be
+// 	   misrepresented as being the original software.
+// 	3. This notice may not be removed or altered from any source distribution.
+// End License
+
+#include <algorithm>
+#include <thread>
+
+#include "../Headers/TQSG.hpp"
+#include "../Headers/TQSG_Particles.hpp"
+
+namespace Slyvina {
+	namespace TQSG {
+
+		_____TPARTICLEEMITTER::_____TPARTICLEEMITTER(TImage Img, size_t Max, int frame) {
+			_Img = Img;
+			_Frame = frame;
+			Resize(Max);
+		}
+
+		void _____TPARTICLEEMITTER::Resize(size_t Max) {
+			_Max = Max;
+			_Count = std::min(_Count, _Max);
+			_X.resize(_Max); _Y.resize(_Max);
+			_VX.resize(_Max); _VY.resize(_Max);
+			_Life.resize(_Max); _MaxLife.resize(_Max);
+			_Scale.resize(_Max); _ScaleSpeed.resize(_Max);
+			_Rot.resize(_Max); _RotSpeed.resize(_Max);
+			_R.resize(_Max); _G.resize(_Max); _B.resize(_Max); _A.resize(_Max);
+		}
+
+		bool _____TPARTICLEEMITTER::Emit(float x, float y, float vx, float vy, float life, float scale, float rot, float rotspeed, byte r, byte g, byte b, byte a, float scalespeed) {
+			if (_Count >= _Max || life <= 0) return false;
+			auto i{ _Count++ };
+			_X[i] = x; _Y[i] = y;
+			_VX[i] = vx; _VY[i] = vy;
+			_Life[i] = life; _MaxLife[i] = life;
+			_Scale[i] = scale; _ScaleSpeed[i] = scalespeed;
+			_Rot[i] = rot; _RotSpeed[i] = rotspeed;
+			_R[i] = r; _G[i] = g; _B[i] = b; _A[i] = a;
+			return true;
+		}
+
+		size_t _____TPARTICLEEMITTER::Burst(size_t num, float x, float y, float minspeed, float maxspeed, float minlife, float maxlife, float scale, byte r, byte g, byte b, byte a) {
+			std::uniform_real_distribution<float>
+				Angle(0, (float)(2 * PI)),
+				Speed(minspeed, std::max(minspeed, maxspeed)),
+				Life(minlife, std::max(minlife, maxlife));
+			size_t ret{ 0 };
+			for (size_t i = 0; i < num && _Count < _Max; i++) {
+				auto ang{ Angle(_Rnd) }, spd{ Speed(_Rnd) };
+				if (Emit(x, y, cos(ang) * spd, sin(ang) * spd, Life(_Rnd), scale, 0, 0, r, g, b, a)) ret++; // A life of 0 or less is just skipped, only a full emitter ends the burst
+			}
+			return ret;
+		}
+
+		void _____TPARTICLEEMITTER::Move(size_t start, size_t end, float dt) {
+			// Keep these loops simple and branch free. That way the compiler can vectorize them.
+			float
+				drag{ (float)pow(1.0 - std::min(std::max((double)Drag, 0.0), 1.0), dt) },
+				gx{ GravityX * dt },
+				gy{ GravityY * dt };
+			float
+				* X{ _X.data() }, * Y{ _Y.data() },
+				* VX{ _VX.data() }, * VY{ _VY.data() },
+				* Life{ _Life.data() },
+				* Scale{ _Scale.data() }, * ScaleSpeed{ _ScaleSpeed.data() },
+				* Rot{ _Rot.data() }, * RotSpeed{ _RotSpeed.data() };
+			for (size_t i = start; i < end; i++) VX[i] = (VX[i] * drag) + gx;
+			for (size_t i = start; i < end; i++) VY[i] = (VY[i] * drag) + gy;
+			for (size_t i = start; i < end; i++) X[i] += VX[i] * dt;
+			for (size_t i = start; i < end; i++) Y[i] += VY[i] * dt;
+			for (size_t i = start; i < end; i++) Life[i] -= dt;
+			for (size_t i = start; i < end; i++) Scale[i] = std::max(0.0f, Scale[i] + (ScaleSpeed[i] * dt));
+			for (size_t i = start; i < end; i++) Rot[i] += RotSpeed[i] * dt;
+		}
+
+		void _____TPARTICLEEMITTER::Update(float dt) {
+			if (!_Count) return;
+			if (ThreadThreshold && _Count >= ThreadThreshold) {
+				size_t
+					parts{ Threads > 0 ? (size_t)Threads : (size_t)std::max(1u, std::thread::hardware_concurrency()) },
+					chunk{ (_Count / parts) + 1 };
+				ParallelRun(parts, [this, chunk, dt](size_t part) {
+					auto start{ part * chunk };
+					if (start < _Count) Move(start, std::min(start + chunk, _Count), dt);
+					});
+			} else Move(0, _Count, dt);
+			// Remove the dead ones by moving the last living one into their place
+			for (size_t i = 0; i < _Count;) {
+				if (_Life[i] > 0) { i++; continue; }
+				auto l{ --_Count };
+				_X[i] = _X[l]; _Y[i] = _Y[l];
+				_VX[i] = _VX[l]; _VY[i] = _VY[l];
+				_Life[i] = _Life[l]; _MaxLife[i] = _MaxLife[l];
+				_Scale[i] = _Scale[l]; _ScaleSpeed[i] = _ScaleSpeed[l];
+				_Rot[i] = _Rot[l]; _RotSpeed[i] = _RotSpeed[l];
+				_R[i] = _R[l]; _G[i] = _G[l]; _B[i] = _B[l]; _A[i] = _A[l];
+			}
+		}
+
+		void _____TPARTICLEEMITTER::Draw(int offsetx, int offsety) {
+			if (!_Count || !_Img) return;
+			auto Tex{ _Img->GetFrame(_Frame) };
+			if (!Tex) return;
+			double rx, ry;
+			int ox, oy;
+			AltScreenRatio(rx, ry);
+			GetOrigin(ox, oy);
+			float
+				w{ (float)_Img->Width() },
+				h{ (float)_Img->Height() },
+				hx{ (float)_Img->HotX() },
+				hy{ (float)_Img->HotY() },
+				fx{ (float)rx },
+				fy{ (float)ry },
+				offx{ (float)(ox + offsetx) },
+				offy{ (float)(oy + offsety) };
+			bool Mapped{ _Img->Mapped(_Frame) };
+			SDL_Rect Source;
+			for (size_t i = 0; i < _Count; i++) {
+				auto s{ _Scale[i] };
+				SDL_FRect Target{
+					(_X[i] - (hx * s) + offx) * fx,
+					(_Y[i] - (hy * s) + offy) * fy,
+					w * s * fx,
+					h * s * fy
+				};
+				SDL_FPoint Center{ hx * s * fx, hy * s * fy };
+				auto PTex{ Tex };
+				if (Mapped && !(PTex = _Img->MapFrame(_Frame, Target, Source, &Center))) continue;
+				byte a{ FadeOut ? (byte)(_A[i] * std::min(1.0f, _Life[i] / _MaxLife[i])) : _A[i] };
+				_Batch.Start(PTex, PBlend); // Only flushes when a particle of another size needs another prescaled copy
+				_Batch.Add(Target, Mapped ? &Source : NULL, _R[i], _G[i], _B[i], a, _Rot[i], Center);
+			}
+			_Batch.Flush();
+		}
+
+		TParticleEmitter CreateParticleEmitter(TImage Img, size_t Max, int frame) {
+			return std::make_shared<_____TPARTICLEEMITTER>(Img, Max, frame);
+		}
+
+		TUParticleEmitter CreateUParticleEmitter(TImage Img, size_t Max, int frame) {
+			return std::make_unique<_____TPARTICLEEMITTER>(Img, Max, frame);
+		}
+	}
+}
@@ -0,0 +1,344 @@
+// License:
+// 	TQSL/Source/TQSG_Scene.cpp
+// 	Tricky's Quick SDL2 Graphics - Scene
+// 	version: 26.10.19
+//
+// 	Copyright (C) 2026 Jeroen P. Broks
+//
+// 	This software is provided 'as-is', without any express or implied
+// 	warranty.  In no event will the authors be held liable for any damages
+// 	arising from the use of this software.
+//
+// 	Permission is granted to anyone to use this software for any purpose,
+// 	including commercial applications, and to alter it and redistribute it
+// 	freely, subject to the following restrictions:
+//
+// 	1. The origin of this software must not be misrepresented; you must not
+// 	   claim that you wrote the original software. If you use this software
+// 	   in a product, an acknowledgment in the product documentation would be
+// 	   appreciated but is not required.
+// 	2. Altered source versions must be plainly marked as such, and must not be
+// 	   misrepresented as being the original software.
+// 	3. This notice may not be removed or altered from any source distribution.
+// End License
+
+#include <algorithm>
+
+#include "../Headers/TQSG.hpp"
+#include "../Headers/TQSG_Scene.hpp"
+
+namespace Slyvina {
+	namespace TQSG {
+
+		static inline int64 CellKey(int cx, int cy) { return ((int64)cx << 32) | (uint32)cy; }
+
+		_____TSCENE::_____TSCENE(int CellSize) { _CellSize = std::max(1, CellSize); }
+
+		_____TSCENE::__Node* _____TSCENE::Get(TSceneID id) {
+			return Exists(id) ? &_Nodes[id - 1] : nullptr;
+		}
+
+		void _____TSCENE::Unregister(TSceneID id, __Node& N) {
+			for (int cx = N.cx1; cx <= N.cx2; cx++) for (int cy = N.cy1; cy <= N.cy2; cy++) {
+				auto C{ _Grid.find(CellKey(cx, cy)) };
+				if (C == _Grid.end()) continue;
+				auto& V{ C->second };
+				auto f{ std::find(V.begin(), V.end(), id) };
+				if (f != V.end()) { *f = V.back(); V.pop_back(); }
+				if (!V.size()) _Grid.erase(C);
+			}
+			N.cx1 = 0; N.cy1 = 0; N.cx2 = -1; N.cy2 = -1;
+		}
+
+		void _____TSCENE::Register(TSceneID id, __Node& N) {
+			for (int cx = N.cx1; cx <= N.cx2; cx++) for (int cy = N.cy1; cy <= N.cy2; cy++) _Grid[CellKey(cx, cy)].push_back(id);
+		}
+
+		void _____TSCENE::Relocate(TSceneID id) {
+			auto& N{ _Nodes[id - 1] };
+			auto& D{ N.N };
+			// Bounding box of the (rotated) image, relative to the hotspot
+			float
+				w{ 0 }, h{ 0 }, hx{ 0 }, hy{ 0 },
+				asx{ std::abs(D.ScaleX) },
+				asy{ std::abs(D.ScaleY) };
+			if (D.Img) {
+				w = D.Img->Width() * asx;
+				h = D.Img->Height() * asy;
+				hx = D.Img->HotX() * asx;
+				hy = D.Img->HotY() * asy;
+			}
+			float
+				lx[4]{ -hx, w - hx, w - hx, -hx },
+				ly[4]{ -hy, -hy, h - hy, h - hy },
+				cs{ 1 }, sn{ 0 };
+			if (D.Rotation) {
+				auto rad{ D.Rotation * PI / 180 };
+				cs = (float)cos(rad);
+				sn = (float)sin(rad);
+			}
+			float
+				x1{ 0 }, y1{ 0 }, x2{ 0 }, y2{ 0 };
+			for (int i = 0; i < 4; i++) {
+				float
+					px{ (lx[i] * cs) - (ly[i] * sn) },
+					py{ (lx[i] * sn) + (ly[i] * cs) };
+				x1 = i ? std::min(x1, px) : px; x2 = i ? std::max(x2, px) : px;
+				y1 = i ? std::min(y1, py) : py; y2 = i ? std::max(y2, py) : py;
+			}
+			N.Bounds = { D.X + x1, D.Y + y1, x2 - x1, y2 - y1 };
+			int
+				cx1{ (int)floor(N.Bounds.x / _CellSize) },
+				cy1{ (int)floor(N.Bounds.y / _CellSize) },
+				cx2{ (int)floor((N.Bounds.x + N.Bounds.w) / _CellSize) },
+				cy2{ (int)floor((N.Bounds.y + N.Bounds.h) / _CellSize) };
+			if (cx1 == N.cx1 && cy1 == N.cy1 && cx2 == N.cx2 && cy2 == N.cy2) return; // Still in the same cells, so the grid needs no update
+			Unregister(id, N);
+			N.cx1 = cx1; N.cy1 = cy1; N.cx2 = cx2; N.cy2 = cy2;
+			Register(id, N);
+		}
+
+		TSceneID _____TSCENE::Add(const TSceneNode& Node) {
+			TSceneID id;
+			if (_Free.size()) {
+				id = _Free.back();
+				_Free.pop_back();
+			} else {
+				_Nodes.push_back(__Node());
+				id = (TSceneID)_Nodes.size();
+			}
+			auto& N{ _Nodes[id - 1] };
+			N = __Node();
+			N.N = Node;
+			N.Used = true;
+			N.Added = ++_Added;
+			_Count++;
+			Relocate(id);
+			return id;
+		}
+
+		TSceneID _____TSCENE::Add(TImage Img, float x, float y, int frame, int z) {
+			TSceneNode Node;
+			Node.Img = Img;
+			Node.X = x;
+			Node.Y = y;
+			Node.Frame = frame;
+			Node.Z = z;
+			return Add(Node);
+		}
+
+		void _____TSCENE::Remove(TSceneID id) {
+			auto N{ Get(id) };
+			if (!N) return;
+			Unregister(id, *N);
+			N->N = TSceneNode(); // Release the image
+			N->Used = false;
+			_Free.push_back(id);
+			_Count--;
+		}
+
+		bool _____TSCENE::Exists(TSceneID id) { return id > 0 && id <= _Nodes.size() && _Nodes[id - 1].Used; }
+
+		void _____TSCENE::Clear() {
+			_Nodes.clear();
+			_Free.clear();
+			_Grid.clear();
+			_Count = 0;
+		}
+
+		const TSceneNode& _____TSCENE::Node(TSceneID id) {
+			static TSceneNode Nothing{};
+			auto N{ Get(id) };
+			return N ? N->N : Nothing;
+		}
+
+		void _____TSCENE::Move(TSceneID id, float x, float y) {
+			auto N{ Get(id) }; if (!N) return;
+			N->N.X = x; N->N.Y = y;
+			Relocate(id);
+		}
+
+		void _____TSCENE::SetImage(TSceneID id, TImage Img, int frame) {
+			auto N{ Get(id) }; if (!N) return;
+			N->N.Img = Img; N->N.Frame = frame;
+			Relocate(id);
+		}
+
+		void _____TSCENE::SetFrame(TSceneID id, int frame) {
+			auto N{ Get(id) }; if (!N) return;
+			N->N.Frame = frame; // All frames have the same size, so no need to relocate
+		}
+
+		void _____TSCENE::SetScale(TSceneID id, float sx, float sy) {
+			auto N{ Get(id) }; if (!N) return;
+			N->N.ScaleX = sx; N->N.ScaleY = sy;
+			Relocate(id);
+		}
+
+		void _____TSCENE::SetRotation(TSceneID id, float degrees) {
+			auto N{ Get(id) }; if (!N) return;
+			N->N.Rotation = degrees;
+			Relocate(id);
+		}
+
+		void _____TSCENE::SetColor(TSceneID id, byte r, byte g, byte b, byte a) {
+			auto N{ Get(id) }; if (!N) return;
+			N->N.R = r; N->N.G = g; N->N.B = b; N->N.A = a;
+		}
+
+		void _____TSCENE::SetBlend(TSceneID id, Blend _blend) {
+			auto N{ Get(id) }; if (!N) return;
+			N->N.NBlend = _blend;
+		}
+
+		void _____TSCENE::SetZ(TSceneID id, int z) {
+			auto N{ Get(id) }; if (!N) return;
+			N->N.Z = z;
+		}
+
+		void _____TSCENE::SetVisible(TSceneID id, bool visible) {
+			auto N{ Get(id) }; if (!N) return;
+			N->N.Visible = visible;
+		}
+
+		size_t _____TSCENE::Query(float x, float y, float w, float h, std::vector<TSceneID>& Result) {
+			Result.clear();
+			if (++_QueryStamp == 0) { // Wrapped around. Very unlikely, but old stamps could then give false 'already seen' results
+				for (auto& N : _Nodes) N.Stamp = 0;
+				_QueryStamp = 1;
+			}
+			int
+				cx1{ (int)floor(x / _CellSize) },
+				cy1{ (int)floor(y / _CellSize) },
+				cx2{ (int)floor((x + w) / _CellSize) },
+				cy2{ (int)floor((y + h) / _CellSize) };
+			for (int cx = cx1; cx <= cx2; cx++) for (int cy = cy1; cy <= cy2; cy++) {
+				auto C{ _Grid.find(CellKey(cx, cy)) };
+				if (C == _Grid.end()) continue;
+				for (auto id : C->second) {
+					auto& N{ _Nodes[id - 1] };
+					if (N.Stamp == _QueryStamp) continue; // Big nodes are in more than one cell
+					N.Stamp = _QueryStamp;
+					if (!N.N.Visible) continue;
+					auto& B{ N.Bounds };
+					if (B.x > x + w || B.y > y + h || B.x + B.w < x || B.y + B.h < y) continue;
+					Result.push_back(id);
+				}
+			}
+			return Result.size();
+		}
+
+		bool _____TSCENE::__DrawOrder::operator<(const __DrawOrder& o) const {
+			if (Z != o.Z) return Z < o.Z;
+			if (Tex != o.Tex) return Tex < o.Tex;
+			if (NBlend != o.NBlend) return NBlend < o.NBlend;
+			return Added < o.Added;
+		}
+
+		// Draw() and Pick() must agree on what's on top, so both sort on this
+		bool _____TSCENE::DrawOrder(TSceneID id, __DrawOrder& O) {
+			auto& N{ _Nodes[id - 1] };
+			auto& D{ N.N };
+			if (!D.Img) return false;
+			auto Tex{ D.Img->GetFrame(D.Frame) };
+			if (!Tex) return false;
+			// Frames without transparency don't need blending as long as the node itself isn't see-through either
+			O = { D.Z, Tex, (D.NBlend == Blend::ALPHA && D.A == 255 && D.Img->Opaque(D.Frame)) ? Blend::NONE : D.NBlend, N.Added, id };
+			return true;
+		}
+
+		size_t _____TSCENE::Pick(float x, float y, std::vector<TSceneID>& Result) {
+			std::vector<TSceneID> Candidates{};
+			Query(x, y, 0, 0, Candidates);
+			Result.clear();
+			for (auto id : Candidates) {
+				auto& D{ _Nodes[id - 1].N };
+				if (!D.Img) continue;
+				// Turn the point back into the unrotated space of the node
+				float
+					dx{ x - D.X },
+					dy{ y - D.Y },
+					cs{ 1 }, sn{ 0 };
+				if (D.Rotation) {
+					auto rad{ -D.Rotation * PI / 180 };
+					cs = (float)cos(rad);
+					sn = (float)sin(rad);
+				}
+				float
+					lx{ (dx * cs) - (dy * sn) },
+					ly{ (dx * sn) + (dy * cs) },
+					asx{ std::abs(D.ScaleX) },
+					asy{ std::abs(D.ScaleY) },
+					hx{ D.Img->HotX() * asx },
+					hy{ D.Img->HotY() * asy };
+				if (lx < -hx || ly < -hy || lx >= (D.Img->Width() * asx) - hx || ly >= (D.Img->Height() * asy) - hy) continue;
+				Result.push_back(id);
+			}
+			// On top first, so the reverse of the order Draw() uses
+			std::vector<__DrawOrder> Order{};
+			Order.reserve(Result.size());
+			for (auto id : Result) {
+				__DrawOrder O;
+				if (DrawOrder(id, O)) Order.push_back(O);
+			}
+			std::sort(Order.begin(), Order.end(), [](const __DrawOrder& a, const __DrawOrder& b) { return b < a; });
+			Result.clear();
+			for (auto& O : Order) Result.push_back(O.id);
+			return Result.size();
+		}
+
+		TSceneID _____TSCENE::Pick(float x, float y) {
+			std::vector<TSceneID> Result{};
+			return Pick(x, y, Result) ? Result[0] : 0;
+		}
+
+		size_t _____TSCENE::Draw(float camx, float camy) {
+			double rx, ry;
+			int ox, oy;
+			AltScreenRatio(rx, ry);
+			GetOrigin(ox, oy);
+			Query(camx - ox, camy - oy, (float)ScreenWidth(), (float)ScreenHeight(), _Found);
+			std::vector<__DrawOrder> Order{};
+			Order.reserve(_Found.size());
+			for (auto id : _Found) {
+				__DrawOrder O;
+				if (DrawOrder(id, O)) Order.push_back(O);
+			}
+			std::sort(Order.begin(), Order.end());
+			float
+				fx{ (float)rx },
+				fy{ (float)ry },
+				offx{ (float)ox - camx },
+				offy{ (float)oy - camy };
+			for (auto& O : Order) {
+				auto& D{ _Nodes[O.id - 1].N };
+				int flip{ SDL_FLIP_NONE };
+				if (D.ScaleX < 0) flip |= SDL_FLIP_HORIZONTAL;
+				if (D.ScaleY < 0) flip |= SDL_FLIP_VERTICAL;
+				float
+					asx{ std::abs(D.ScaleX) },
+					asy{ std::abs(D.ScaleY) },
+					hx{ D.Img->HotX() * asx },
+					hy{ D.Img->HotY() * asy };
+				SDL_FRect Target{
+					(D.X - hx + offx) * fx,
+					(D.Y - hy + offy) * fy,
+					D.Img->Width() * asx * fx,
+					D.Img->Height() * asy * fy
+				};
+				SDL_FPoint Center{ hx * fx, hy * fy };
+				SDL_Rect Source;
+				auto Tex{ O.Tex };
+				auto Mapped{ D.Img->Mapped(D.Frame) };
+				if (Mapped && !(Tex = D.Img->MapFrame(D.Frame, Target, Source, &Center, flip))) continue;
+				_Batch.Start(Tex, O.NBlend);
+				_Batch.Add(Target, Mapped ? &Source : NULL, D.R, D.G, D.B, D.A, D.Rotation, Center, flip);
+			}
+			_Batch.Flush();
+			return Order.size();
+		}
+
+		TScene CreateScene(int CellSize) { return std::make_shared<_____TSCENE>(CellSize); }
+		TUScene CreateUScene(int CellSize) { return std::make_unique<_____TSCENE>(CellSize); }
+	}
+}